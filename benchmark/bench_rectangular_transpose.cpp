@@ -20,10 +20,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <array>
 #include <benchmark/benchmark.h>
 #include <bit_transpose.h>
 #include <immintrin.h>
 #include <random>
+#include <vector>
 
 static void BM_transpose_bit_8xN(benchmark::State& state) {
     std::random_device rd;
@@ -217,3 +220,149 @@ static void BM_transpose_bit_Nx128(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_transpose_bit_Nx128);
+
+// The following benchmarks take the number of blocks N as argument, such that
+// they can be run with matrices exceeding the last level cache.  Then, the rows
+// are streamed from or to memory.
+
+static void BM_transpose_bit_64xN_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(64 * N);
+    std::vector<std::uint64_t> output(64 * N);
+    std::array<const std::uint8_t*, 64> input_ptrs;
+    for (std::size_t i = 0; i < 64; ++i) {
+        input_ptrs[i] = reinterpret_cast<const std::uint8_t*>(matrix.data() + i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_64xN(output.data(), input_ptrs.data(), N);
+    }
+    state.SetBytesProcessed(state.iterations() * 512 * N);
+}
+BENCHMARK(BM_transpose_bit_64xN_large)->Arg(1 << 10)->Arg(1 << 18);
+
+static void BM_transpose_bit_Nx64_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(64 * N);
+    std::vector<std::uint64_t> output(64 * N);
+    std::array<std::uint8_t*, 64> output_ptrs;
+    for (std::size_t i = 0; i < 64; ++i) {
+        output_ptrs[i] = reinterpret_cast<std::uint8_t*>(output.data() + i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_Nx64(output_ptrs.data(), matrix.data(), N);
+    }
+    state.SetBytesProcessed(state.iterations() * 512 * N);
+}
+BENCHMARK(BM_transpose_bit_Nx64_large)->Arg(1 << 10)->Arg(1 << 18);
+
+static void BM_transpose_bit_128xN_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(256 * N);
+    std::vector<std::uint64_t> output(256 * N);
+    std::array<const std::uint8_t*, 128> input_ptrs;
+    for (std::size_t i = 0; i < 128; ++i) {
+        input_ptrs[i] = reinterpret_cast<const std::uint8_t*>(matrix.data() + 2 * i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_128xN(reinterpret_cast<std::uint8_t*>(output.data()), input_ptrs.data(), N);
+    }
+    state.SetBytesProcessed(state.iterations() * 2048 * N);
+}
+BENCHMARK(BM_transpose_bit_128xN_large)->Arg(1 << 9)->Arg(1 << 17);
+
+static void BM_transpose_bit_Nx128_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(256 * N);
+    std::vector<std::uint64_t> output(256 * N);
+    std::array<std::uint8_t*, 128> output_ptrs;
+    for (std::size_t i = 0; i < 128; ++i) {
+        output_ptrs[i] = reinterpret_cast<std::uint8_t*>(output.data() + 2 * i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_Nx128(output_ptrs.data(), reinterpret_cast<const std::uint8_t*>(matrix.data()),
+                            N);
+    }
+    state.SetBytesProcessed(state.iterations() * 2048 * N);
+}
+BENCHMARK(BM_transpose_bit_Nx128_large)->Arg(1 << 9)->Arg(1 << 17);
+
+static void BM_transpose_bit_Nx64_staged_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(64 * N);
+    std::vector<std::uint64_t> output(64 * N);
+    std::array<std::uint8_t*, 64> output_ptrs;
+    for (std::size_t i = 0; i < 64; ++i) {
+        output_ptrs[i] = reinterpret_cast<std::uint8_t*>(output.data() + i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_Nx64_staged(output_ptrs.data(), matrix.data(), N);
+    }
+    state.SetBytesProcessed(state.iterations() * 512 * N);
+}
+BENCHMARK(BM_transpose_bit_Nx64_staged_large)->Arg(1 << 10)->Arg(1 << 18);
+
+static void BM_transpose_bit_Nx128_staged_large(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t N = state.range(0);
+    std::vector<std::uint64_t> matrix(256 * N);
+    std::vector<std::uint64_t> output(256 * N);
+    std::array<std::uint8_t*, 128> output_ptrs;
+    for (std::size_t i = 0; i < 128; ++i) {
+        output_ptrs[i] = reinterpret_cast<std::uint8_t*>(output.data() + 2 * i * N);
+    }
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_Nx128_staged(output_ptrs.data(),
+                                   reinterpret_cast<const std::uint8_t*>(matrix.data()), N);
+    }
+    state.SetBytesProcessed(state.iterations() * 2048 * N);
+}
+BENCHMARK(BM_transpose_bit_Nx128_staged_large)->Arg(1 << 9)->Arg(1 << 17);
+
+// The following benchmarks transpose square matrices of 2^k x 2^k bits, ranging
+// from sizes fitting into the L2 cache to sizes exceeding the last level cache.
+
+template <void (*transpose)(std::uint8_t*, std::size_t, const std::uint8_t*, std::size_t,
+                            std::size_t, std::size_t)>
+static void BM_transpose_bit_matrix(benchmark::State& state) {
+    std::mt19937_64 mt(0);
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    const std::size_t size = state.range(0);
+    std::vector<std::uint64_t> matrix(size * size / 64);
+    std::vector<std::uint64_t> output(size * size / 64);
+    std::generate(matrix.begin(), matrix.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose(reinterpret_cast<std::uint8_t*>(output.data()), size / 8,
+                  reinterpret_cast<const std::uint8_t*>(matrix.data()), size / 8, size, size);
+    }
+    state.SetBytesProcessed(state.iterations() * size * size / 8);
+}
+BENCHMARK_TEMPLATE(BM_transpose_bit_matrix, transpose_bit_matrix)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_transpose_bit_matrix, transpose_bit_matrix_recursive)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
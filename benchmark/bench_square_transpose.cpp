@@ -20,10 +20,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <array>
 #include <benchmark/benchmark.h>
 #include <bit_transpose.h>
 #include <immintrin.h>
 #include <random>
+#include <vector>
 
 static void BM_transpose_bit_8x8_direct(benchmark::State& state) {
     for (auto _ : state) {
@@ -129,6 +132,39 @@ static void BM_transpose_bit_64x64_inplace_aligned(benchmark::State& state) {
 }
 BENCHMARK(BM_transpose_bit_64x64_inplace_aligned);
 
+static void BM_transpose_bit_64x64_batch(benchmark::State& state) {
+    std::random_device rd;
+    std::mt19937_64 mt(rd());
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    constexpr std::size_t count = 1024;
+    std::vector<std::uint64_t> matrices(64 * count);
+    std::vector<std::uint64_t> output(64 * count);
+    std::generate(matrices.begin(), matrices.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        transpose_bit_64x64_batch(output.data(), matrices.data(), count);
+    }
+}
+BENCHMARK(BM_transpose_bit_64x64_batch);
+
+/* the same work as BM_transpose_bit_64x64_batch, one call per matrix */
+static void BM_transpose_bit_64x64_loop(benchmark::State& state) {
+    std::random_device rd;
+    std::mt19937_64 mt(rd());
+    std::uniform_int_distribution<std::uint64_t> dist(0);
+    constexpr std::size_t count = 1024;
+    std::vector<std::uint64_t> matrices(64 * count);
+    std::vector<std::uint64_t> output(64 * count);
+    std::generate(matrices.begin(), matrices.end(), [&] { return dist(mt); });
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < count; ++i) {
+            transpose_bit_64x64(&output[64 * i], &matrices[64 * i]);
+        }
+    }
+}
+BENCHMARK(BM_transpose_bit_64x64_loop);
+
 static void BM_transpose_bit_128x128_inplace(benchmark::State& state) {
     std::random_device rd;
     std::mt19937_64 mt(rd());
@@ -31,12 +31,22 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 
+/* Returns the name of the backend used by this library, e.g., "plain", "ssse3",
+ * or "avx512_gfni".  If the library was built with runtime dispatch, this is
+ * the backend that was selected for the current CPU when the library was
+ * loaded.
+ */
+const char* transpose_bit_backend(void);
+
 /* Functions to transpose square bit matrices.
  *
  * - Functions with the suffix `_direct` take and return a matrix by value.
+ * - Functions without `_direct` or `_inplace` read the matrix from src and write
+ *   the transposed matrix to dst.  The two buffers may be identical, but must
+ *   not overlap otherwise.
  * - Functions with the suffix `_inplace` write the transposed matrix back into
  *   the same buffer.  They might use additional memory on the stack.
- * - Functions with the suffix `_aligned` require the pointer to be aligned on
+ * - Functions with the suffix `_aligned` require the pointers to be aligned on
  *   32-byte boundaries.
  */
 
@@ -53,6 +63,39 @@ void transpose_bit_64x64_inplace_aligned(void* input);
 void transpose_bit_128x128_inplace(void* input);
 void transpose_bit_128x128_inplace_aligned(void* input);
 
+void transpose_bit_8x8(void* dst, const void* src);
+void transpose_bit_8x8_packed_x4(void* dst, const void* src);
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src);
+void transpose_bit_16x16(void* dst, const void* src);
+void transpose_bit_16x16_aligned(void* dst, const void* src);
+void transpose_bit_32x32(void* dst, const void* src);
+void transpose_bit_32x32_aligned(void* dst, const void* src);
+void transpose_bit_64x64(void* dst, const void* src);
+void transpose_bit_64x64_aligned(void* dst, const void* src);
+void transpose_bit_128x128(void* dst, const void* src);
+void transpose_bit_128x128_aligned(void* dst, const void* src);
+
+/* Functions to transpose arrays of square bit matrices.
+ *
+ * - Functions with the suffix `_batch` transpose the count matrices stored
+ *   consecutively at src and write them to dst.  The two buffers may be
+ *   identical, but must not overlap otherwise.
+ * - Functions with the suffix `_batch_inplace` write the transposed matrices
+ *   back into the same buffer.
+ *
+ * The buffers need not be aligned.
+ */
+void transpose_bit_8x8_batch(void* dst, const void* src, size_t count);
+void transpose_bit_8x8_batch_inplace(void* matrices, size_t count);
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count);
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count);
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count);
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count);
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count);
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count);
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count);
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count);
+
 /* Functions to transpose rectangular bit matrices of size (k x m) where k is
  * one of 8/16/32/64/128 and m = k * N.  Thus, N denotes the number of (k x k)
  * blocks of the matrix.
@@ -74,6 +117,136 @@ void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N);
 void transpose_bit_128xN(uint8_t* dst, const uint8_t* const* src, size_t N);
 void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N);
 
+/* Variants of the rectangular transpositions above which require the buffer
+ * holding the blocks (dst for kxN, src for Nxk) to be aligned on a 32-byte
+ * boundary; the row pointers need not be aligned.  They skip the staging
+ * copies of the blocks in backends whose kernels need aligned operands.  The
+ * functions above check the alignment at runtime and take the same path if
+ * possible, so these only save the check.
+ */
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N);
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N);
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N);
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N);
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N);
+
+/* Variants of the rectangular transpositions with a number of columns (for
+ * kxN) or rows (for Nxk) in bits, which need not be a multiple of k.
+ *
+ * For the kxN variants:
+ * - src is an array of k pointers to rows of num_cols bits each, of which only
+ *   the first (num_cols + 7) / 8 bytes are read
+ * - dst is a buffer of num_cols rows of k bits each
+ *
+ * For the Nxk variants it is the other way round.  Of the last byte of each
+ * row of dst, only the bits belonging to the num_rows columns are written.
+ */
+void transpose_bit_8xN_bits(uint8_t* dst, const uint8_t* const* src, size_t num_cols);
+void transpose_bit_Nx8_bits(uint8_t** dst, const uint8_t* src, size_t num_rows);
+void transpose_bit_16xN_bits(uint16_t* dst, const uint8_t* const* src, size_t num_cols);
+void transpose_bit_Nx16_bits(uint8_t** dst, const uint16_t* src, size_t num_rows);
+void transpose_bit_32xN_bits(uint32_t* dst, const uint8_t* const* src, size_t num_cols);
+void transpose_bit_Nx32_bits(uint8_t** dst, const uint32_t* src, size_t num_rows);
+void transpose_bit_64xN_bits(uint64_t* dst, const uint8_t* const* src, size_t num_cols);
+void transpose_bit_Nx64_bits(uint8_t** dst, const uint64_t* src, size_t num_rows);
+void transpose_bit_128xN_bits(uint8_t* dst, const uint8_t* const* src, size_t num_cols);
+void transpose_bit_Nx128_bits(uint8_t** dst, const uint8_t* src, size_t num_rows);
+
+/* Rectangular transpositions for an arbitrary number of rows k.  Each row of
+ * the tall side consists of (k + 7) / 8 bytes.
+ *
+ * For transpose_bit_kxN:
+ * - src is an array of k pointers to rows of num_cols bits each
+ * - dst is a buffer of num_cols rows of (k + 7) / 8 bytes each, in which the
+ *   bits after the first k are cleared
+ *
+ * For transpose_bit_Nxk it is the other way round, and the bits after the
+ * first k of each row of src are ignored.  Otherwise, the same rules as for
+ * the _bits variants above apply.
+ */
+void transpose_bit_kxN(uint8_t* dst, const uint8_t* const* src, size_t k, size_t num_cols);
+void transpose_bit_Nxk(uint8_t** dst, const uint8_t* src, size_t k, size_t num_rows);
+
+/* Variants of the rectangular transpositions for matrices stored with a fixed
+ * row stride instead of an array of row pointers.  Row i of src starts at
+ * src + i * src_stride, and row i of dst at dst + i * dst_stride (strides are
+ * given in bytes).
+ *
+ * For the kxN variants:
+ * - src contains k rows of N*k bits each
+ * - dst contains N*k rows of k bits each; they are packed if dst_stride is k/8
+ *
+ * For the Nxk variants it is the other way round.  The output is fastest to
+ * write (or the input to read) if the rows with k bits are packed.
+ */
+void transpose_bit_8xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                               size_t src_stride, size_t N);
+void transpose_bit_Nx8_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                               size_t src_stride, size_t N);
+void transpose_bit_16xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_Nx16_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_32xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_Nx32_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_64xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_Nx64_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N);
+void transpose_bit_128xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                 size_t src_stride, size_t N);
+void transpose_bit_Nx128_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                 size_t src_stride, size_t N);
+
+/* Transposes a bit matrix of arbitrary size.  src contains num_rows rows of
+ * num_cols bits each, and dst receives num_cols rows of num_rows bits each.
+ * Row i of src starts at src + i * src_stride, and row j of dst at
+ * dst + j * dst_stride (strides are given in bytes).  Only the first
+ * (num_cols + 7) / 8 bytes of each row of src are read, and of the last byte
+ * of each row of dst, only the bits belonging to the num_rows columns are
+ * written.
+ */
+void transpose_bit_matrix(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                          size_t src_stride, size_t num_rows, size_t num_cols);
+
+/* Cache-oblivious variant of transpose_bit_matrix, which recursively halves
+ * the larger dimension of the matrix until the tiles fit into the L1 cache.
+ * It does not depend on the cache sizes and avoids streaming a whole dimension
+ * of very large matrices (e.g., exceeding the last level cache) at once.
+ */
+void transpose_bit_matrix_recursive(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                    size_t src_stride, size_t num_rows, size_t num_cols);
+
+/* Variants of the rectangular transpositions which write the output with
+ * non-temporal (streaming) stores that bypass the caches.  This avoids
+ * evicting the working set if the output is large and not used again soon.
+ *
+ * Streaming stores are only used if dst (for 64xN and 128xN) or each row
+ * pointer (for Nx128) is aligned to the vector size of the backend; otherwise,
+ * and in backends without streaming stores, these functions behave like the
+ * ones above.  The latter switch to streaming stores automatically if the
+ * output has at least BITTRANSPOSE_STREAMING_THRESHOLD bytes (16 MiB unless
+ * changed when building the library).
+ */
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N);
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N);
+
+/* Variants of the Nx64 and Nx128 transpositions which collect the output of
+ * several consecutive blocks in a small staging tile and copy it to each row
+ * of dst in bursts of whole cache lines.  Thus, fewer rows (and pages) of dst
+ * are written concurrently, which can help if the rows lie far apart.
+ */
+void transpose_bit_Nx64_staged(uint8_t** dst, const uint64_t* src, size_t N);
+void transpose_bit_Nx128_staged(uint8_t** dst, const uint8_t* src, size_t N);
+
 #ifdef __cplusplus
 }
 #endif
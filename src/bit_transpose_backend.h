@@ -0,0 +1,133 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_BACKEND_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_BACKEND_H
+
+/* Every backend is compiled with BITTRANSPOSE_BACKEND set to its name (e.g.,
+ * `avx2`).  This header has to be included before any other header of the
+ * library.
+ *
+ * If the library is built with runtime dispatch, all backends are linked into
+ * the same library.  In this case, the external symbols of a backend get its
+ * name as suffix (e.g., transpose_bit_8xN_avx2), and the unsuffixed public
+ * symbols are resolved at load time (see dispatch.c).
+ */
+
+#ifndef BITTRANSPOSE_BACKEND
+#error "BITTRANSPOSE_BACKEND is not defined"
+#endif
+
+#define BITTRANSPOSE_STRINGIFY_(x) #x
+#define BITTRANSPOSE_STRINGIFY(x) BITTRANSPOSE_STRINGIFY_(x)
+#define BITTRANSPOSE_CONCAT_(a, b) a##_##b
+#define BITTRANSPOSE_CONCAT(a, b) BITTRANSPOSE_CONCAT_(a, b)
+
+#define BITTRANSPOSE_BACKEND_NAME BITTRANSPOSE_STRINGIFY(BITTRANSPOSE_BACKEND)
+#define BITTRANSPOSE_SYMBOL(name) BITTRANSPOSE_CONCAT(name, BITTRANSPOSE_BACKEND)
+
+#ifdef BITTRANSPOSE_RUNTIME_DISPATCH
+
+/* public functions (keep in sync with the list in dispatch.c) */
+#define transpose_bit_backend BITTRANSPOSE_SYMBOL(transpose_bit_backend)
+#define transpose_bit_8x8_direct BITTRANSPOSE_SYMBOL(transpose_bit_8x8_direct)
+#define transpose_bit_8x8_inplace BITTRANSPOSE_SYMBOL(transpose_bit_8x8_inplace)
+#define transpose_bit_8x8_packed_x4_inplace BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4_inplace)
+#define transpose_bit_8x8_packed_x4_inplace_aligned BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4_inplace_aligned)
+#define transpose_bit_16x16_inplace BITTRANSPOSE_SYMBOL(transpose_bit_16x16_inplace)
+#define transpose_bit_16x16_inplace_aligned BITTRANSPOSE_SYMBOL(transpose_bit_16x16_inplace_aligned)
+#define transpose_bit_32x32_inplace BITTRANSPOSE_SYMBOL(transpose_bit_32x32_inplace)
+#define transpose_bit_32x32_inplace_aligned BITTRANSPOSE_SYMBOL(transpose_bit_32x32_inplace_aligned)
+#define transpose_bit_64x64_inplace BITTRANSPOSE_SYMBOL(transpose_bit_64x64_inplace)
+#define transpose_bit_64x64_inplace_aligned BITTRANSPOSE_SYMBOL(transpose_bit_64x64_inplace_aligned)
+#define transpose_bit_128x128_inplace BITTRANSPOSE_SYMBOL(transpose_bit_128x128_inplace)
+#define transpose_bit_128x128_inplace_aligned BITTRANSPOSE_SYMBOL(transpose_bit_128x128_inplace_aligned)
+#define transpose_bit_8x8 BITTRANSPOSE_SYMBOL(transpose_bit_8x8)
+#define transpose_bit_8x8_packed_x4 BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4)
+#define transpose_bit_8x8_packed_x4_aligned BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4_aligned)
+#define transpose_bit_16x16 BITTRANSPOSE_SYMBOL(transpose_bit_16x16)
+#define transpose_bit_16x16_aligned BITTRANSPOSE_SYMBOL(transpose_bit_16x16_aligned)
+#define transpose_bit_32x32 BITTRANSPOSE_SYMBOL(transpose_bit_32x32)
+#define transpose_bit_32x32_aligned BITTRANSPOSE_SYMBOL(transpose_bit_32x32_aligned)
+#define transpose_bit_64x64 BITTRANSPOSE_SYMBOL(transpose_bit_64x64)
+#define transpose_bit_64x64_aligned BITTRANSPOSE_SYMBOL(transpose_bit_64x64_aligned)
+#define transpose_bit_128x128 BITTRANSPOSE_SYMBOL(transpose_bit_128x128)
+#define transpose_bit_128x128_aligned BITTRANSPOSE_SYMBOL(transpose_bit_128x128_aligned)
+#define transpose_bit_8x8_batch BITTRANSPOSE_SYMBOL(transpose_bit_8x8_batch)
+#define transpose_bit_8x8_batch_inplace BITTRANSPOSE_SYMBOL(transpose_bit_8x8_batch_inplace)
+#define transpose_bit_16x16_batch BITTRANSPOSE_SYMBOL(transpose_bit_16x16_batch)
+#define transpose_bit_16x16_batch_inplace BITTRANSPOSE_SYMBOL(transpose_bit_16x16_batch_inplace)
+#define transpose_bit_32x32_batch BITTRANSPOSE_SYMBOL(transpose_bit_32x32_batch)
+#define transpose_bit_32x32_batch_inplace BITTRANSPOSE_SYMBOL(transpose_bit_32x32_batch_inplace)
+#define transpose_bit_64x64_batch BITTRANSPOSE_SYMBOL(transpose_bit_64x64_batch)
+#define transpose_bit_64x64_batch_inplace BITTRANSPOSE_SYMBOL(transpose_bit_64x64_batch_inplace)
+#define transpose_bit_128x128_batch BITTRANSPOSE_SYMBOL(transpose_bit_128x128_batch)
+#define transpose_bit_128x128_batch_inplace BITTRANSPOSE_SYMBOL(transpose_bit_128x128_batch_inplace)
+#define transpose_bit_8xN BITTRANSPOSE_SYMBOL(transpose_bit_8xN)
+#define transpose_bit_Nx8 BITTRANSPOSE_SYMBOL(transpose_bit_Nx8)
+#define transpose_bit_16xN BITTRANSPOSE_SYMBOL(transpose_bit_16xN)
+#define transpose_bit_Nx16 BITTRANSPOSE_SYMBOL(transpose_bit_Nx16)
+#define transpose_bit_32xN BITTRANSPOSE_SYMBOL(transpose_bit_32xN)
+#define transpose_bit_Nx32 BITTRANSPOSE_SYMBOL(transpose_bit_Nx32)
+#define transpose_bit_64xN BITTRANSPOSE_SYMBOL(transpose_bit_64xN)
+#define transpose_bit_Nx64 BITTRANSPOSE_SYMBOL(transpose_bit_Nx64)
+#define transpose_bit_128xN BITTRANSPOSE_SYMBOL(transpose_bit_128xN)
+#define transpose_bit_Nx128 BITTRANSPOSE_SYMBOL(transpose_bit_Nx128)
+#define transpose_bit_8xN_aligned BITTRANSPOSE_SYMBOL(transpose_bit_8xN_aligned)
+#define transpose_bit_Nx8_aligned BITTRANSPOSE_SYMBOL(transpose_bit_Nx8_aligned)
+#define transpose_bit_16xN_aligned BITTRANSPOSE_SYMBOL(transpose_bit_16xN_aligned)
+#define transpose_bit_Nx16_aligned BITTRANSPOSE_SYMBOL(transpose_bit_Nx16_aligned)
+#define transpose_bit_32xN_aligned BITTRANSPOSE_SYMBOL(transpose_bit_32xN_aligned)
+#define transpose_bit_Nx32_aligned BITTRANSPOSE_SYMBOL(transpose_bit_Nx32_aligned)
+#define transpose_bit_64xN_aligned BITTRANSPOSE_SYMBOL(transpose_bit_64xN_aligned)
+#define transpose_bit_Nx64_aligned BITTRANSPOSE_SYMBOL(transpose_bit_Nx64_aligned)
+#define transpose_bit_128xN_aligned BITTRANSPOSE_SYMBOL(transpose_bit_128xN_aligned)
+#define transpose_bit_Nx128_aligned BITTRANSPOSE_SYMBOL(transpose_bit_Nx128_aligned)
+#define transpose_bit_64xN_nt BITTRANSPOSE_SYMBOL(transpose_bit_64xN_nt)
+#define transpose_bit_128xN_nt BITTRANSPOSE_SYMBOL(transpose_bit_128xN_nt)
+#define transpose_bit_Nx128_nt BITTRANSPOSE_SYMBOL(transpose_bit_Nx128_nt)
+
+/* internal functions shared between the sources of a backend */
+#define transpose_bit_8x8_packed_x4_direct BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4_direct)
+#define transpose_bit_16x16_direct BITTRANSPOSE_SYMBOL(transpose_bit_16x16_direct)
+#define transpose_bit_128x128_gather BITTRANSPOSE_SYMBOL(transpose_bit_128x128_gather)
+#define transpose_bit_128x128_gather_stream BITTRANSPOSE_SYMBOL(transpose_bit_128x128_gather_stream)
+#define transpose_bit_8x8_packed_x2_direct BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x2_direct)
+#define transpose_bit_16x16_xmm BITTRANSPOSE_SYMBOL(transpose_bit_16x16_xmm)
+#define transpose_bit_32x32_xmm BITTRANSPOSE_SYMBOL(transpose_bit_32x32_xmm)
+#define transpose_bit_64x64_xmm BITTRANSPOSE_SYMBOL(transpose_bit_64x64_xmm)
+#define transpose_bit_128x128_xmm BITTRANSPOSE_SYMBOL(transpose_bit_128x128_xmm)
+#define transpose_bit_8x8_packed_x4_vec BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x4_vec)
+#define transpose_bit_16x16_vec BITTRANSPOSE_SYMBOL(transpose_bit_16x16_vec)
+#define transpose_bit_32x32_vec BITTRANSPOSE_SYMBOL(transpose_bit_32x32_vec)
+#define transpose_bit_64x64_vec BITTRANSPOSE_SYMBOL(transpose_bit_64x64_vec)
+#define transpose_bit_128x128_vec BITTRANSPOSE_SYMBOL(transpose_bit_128x128_vec)
+#define transpose_bit_8x8_packed_x8_direct BITTRANSPOSE_SYMBOL(transpose_bit_8x8_packed_x8_direct)
+#define transpose_bit_16x16_packed_x2_direct BITTRANSPOSE_SYMBOL(transpose_bit_16x16_packed_x2_direct)
+#define transpose_bit_32x32_zmm BITTRANSPOSE_SYMBOL(transpose_bit_32x32_zmm)
+#define transpose_bit_64x64_zmm BITTRANSPOSE_SYMBOL(transpose_bit_64x64_zmm)
+#define transpose_bit_128x128_zmm BITTRANSPOSE_SYMBOL(transpose_bit_128x128_zmm)
+
+#endif /* BITTRANSPOSE_RUNTIME_DISPATCH */
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_BACKEND_H */
@@ -0,0 +1,53 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_BATCH_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_BATCH_H
+
+#include <stddef.h>
+
+/* Helpers for the batched square transpositions. */
+
+/* The batch functions prefetch the input this many bytes ahead of the matrices
+ * which are currently transposed. */
+#define BITTRANSPOSE_BATCH_PREFETCH_DISTANCE 1024
+
+/* Prefetch the cache lines covering the size bytes which follow the given
+ * offset by the prefetch distance, as far as they are within the first total
+ * bytes of the buffer. */
+static inline void prefetch_batch(const void* buffer, size_t offset, size_t size, size_t total) {
+#if defined(__GNUC__)
+    const char* bytes = (const char*)(buffer);
+    for (size_t i = offset + BITTRANSPOSE_BATCH_PREFETCH_DISTANCE;
+         i < offset + BITTRANSPOSE_BATCH_PREFETCH_DISTANCE + size && i < total; i += 64) {
+        __builtin_prefetch(bytes + i, 0, 3);
+    }
+#else
+    (void)buffer;
+    (void)offset;
+    (void)size;
+    (void)total;
+#endif
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_BATCH_H */
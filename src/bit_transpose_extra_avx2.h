@@ -21,7 +21,22 @@
  * SOFTWARE.
  */
 
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX2_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX2_H
+
 #include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
 
 __m256i transpose_bit_8x8_packed_x4_direct(__m256i matrix);
 __m256i transpose_bit_16x16_direct(__m256i matrix);
+
+/* Transpose a 128x128 matrix whose rows are the 16 byte words at src[i] + offset
+ * and write the result to the 2048 bytes at dst. */
+void transpose_bit_128x128_gather(void* dst, const uint8_t* const* src, size_t offset);
+
+/* As above, but write the result with streaming stores.  dst must be 32 byte
+ * aligned, and the caller has to issue a store fence afterwards. */
+void transpose_bit_128x128_gather_stream(void* dst, const uint8_t* const* src, size_t offset);
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX2_H */
@@ -0,0 +1,64 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX512_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX512_H
+
+#include "bit_transpose_extra_avx2.h"
+
+#include <immintrin.h>
+
+__m512i transpose_bit_8x8_packed_x8_direct(__m512i matrix);
+__m512i transpose_bit_16x16_packed_x2_direct(__m512i matrix);
+
+/* The following functions transpose a matrix held in an array of registers,
+ * i.e., 2, 8, and 32 registers, respectively.  After inlining, the compiler is
+ * free to keep them in registers. */
+void transpose_bit_32x32_zmm(__m512i* matrix);
+void transpose_bit_64x64_zmm(__m512i* matrix);
+void transpose_bit_128x128_zmm(__m512i* matrix);
+
+/* Permute the words of a pair of registers with vpermt2w/vpermt2d/vpermt2q. */
+
+static inline void permute_pair_epi16(__m512i* a, __m512i* b, const __m512i index_a,
+                                      const __m512i index_b) {
+    __m512i tmp = _mm512_permutex2var_epi16(*a, index_a, *b);
+    *b = _mm512_permutex2var_epi16(*a, index_b, *b);
+    *a = tmp;
+}
+
+static inline void permute_pair_epi32(__m512i* a, __m512i* b, const __m512i index_a,
+                                      const __m512i index_b) {
+    __m512i tmp = _mm512_permutex2var_epi32(*a, index_a, *b);
+    *b = _mm512_permutex2var_epi32(*a, index_b, *b);
+    *a = tmp;
+}
+
+static inline void permute_pair_epi64(__m512i* a, __m512i* b, const __m512i index_a,
+                                      const __m512i index_b) {
+    __m512i tmp = _mm512_permutex2var_epi64(*a, index_a, *b);
+    *b = _mm512_permutex2var_epi64(*a, index_b, *b);
+    *a = tmp;
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_AVX512_H */
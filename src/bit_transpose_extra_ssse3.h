@@ -0,0 +1,41 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_SSSE3_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_SSSE3_H
+
+#include <immintrin.h>
+
+/* Transpose the two 8x8 matrices in the 64 bit words of a register. */
+__m128i transpose_bit_8x8_packed_x2_direct(__m128i matrix);
+
+/* Transpose a matrix stored in consecutive registers: a 16x16 matrix takes 2,
+ * a 32x32 matrix 8, a 64x64 matrix 32, and a 128x128 matrix 128 registers.
+ * The result is written to dst which may be equal to src.
+ */
+void transpose_bit_16x16_xmm(__m128i* dst, const __m128i* src);
+void transpose_bit_32x32_xmm(__m128i* dst, const __m128i* src);
+void transpose_bit_64x64_xmm(__m128i* dst, const __m128i* src);
+void transpose_bit_128x128_xmm(__m128i* dst, const __m128i* src);
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_SSSE3_H */
@@ -0,0 +1,109 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_VECTOR_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_VECTOR_H
+
+#include <stdint.h>
+
+/* 256 bit vectors using the vector extensions of GCC and Clang.  Depending on
+ * the target, the compiler lowers operations on them to SSE, AVX2, AVX-512,
+ * NEON, etc. or to scalar code.
+ */
+typedef uint8_t u8x32 __attribute__((vector_size(32)));
+typedef uint16_t u16x16 __attribute__((vector_size(32)));
+typedef uint32_t u32x8 __attribute__((vector_size(32)));
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+
+/* SHUFFLE(type, a, b, indices...) selects the elements with the given indices
+ * from the concatenation of a and b (both of the given vector type).
+ */
+#ifdef __clang__
+#define SHUFFLE(type, a, b, ...) __builtin_shufflevector((a), (b), __VA_ARGS__)
+#else
+#define SHUFFLE(type, a, b, ...) __builtin_shuffle((a), (b), (type){__VA_ARGS__})
+#endif
+
+/* Transpose the four 8x8 matrices in the 64 bit words of a vector. */
+void transpose_bit_8x8_packed_x4_vec(u64x4* matrix);
+
+/* Transpose a matrix stored in consecutive vectors: a 16x16 matrix takes 1, a
+ * 32x32 matrix 4, a 64x64 matrix 16, and a 128x128 matrix 64 vectors.  (The
+ * vectors are passed by pointer since passing them by value depends on
+ * whether AVX is enabled.)  The result is written to dst which may be equal to
+ * src.
+ */
+void transpose_bit_16x16_vec(u16x16* dst, const u16x16* src);
+void transpose_bit_32x32_vec(u32x8* dst, const u32x8* src);
+void transpose_bit_64x64_vec(u64x4* dst, const u64x4* src);
+void transpose_bit_128x128_vec(u64x4* dst, const u64x4* src);
+
+/* Split the elements of a and b into the even and the odd ones, and the
+ * inverse operation.
+ */
+static inline void split_u16x16(u16x16* a, u16x16* b) {
+    u16x16 even = SHUFFLE(u16x16, *a, *b, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28,
+                          30);
+    u16x16 odd = SHUFFLE(u16x16, *a, *b, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29,
+                         31);
+    *a = even;
+    *b = odd;
+}
+
+static inline void merge_u16x16(u16x16* a, u16x16* b) {
+    u16x16 lo = SHUFFLE(u16x16, *a, *b, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    u16x16 hi = SHUFFLE(u16x16, *a, *b, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15,
+                        31);
+    *a = lo;
+    *b = hi;
+}
+
+static inline void split_u32x8(u32x8* a, u32x8* b) {
+    u32x8 even = SHUFFLE(u32x8, *a, *b, 0, 2, 4, 6, 8, 10, 12, 14);
+    u32x8 odd = SHUFFLE(u32x8, *a, *b, 1, 3, 5, 7, 9, 11, 13, 15);
+    *a = even;
+    *b = odd;
+}
+
+static inline void merge_u32x8(u32x8* a, u32x8* b) {
+    u32x8 lo = SHUFFLE(u32x8, *a, *b, 0, 8, 1, 9, 2, 10, 3, 11);
+    u32x8 hi = SHUFFLE(u32x8, *a, *b, 4, 12, 5, 13, 6, 14, 7, 15);
+    *a = lo;
+    *b = hi;
+}
+
+static inline void split_u64x4(u64x4* a, u64x4* b) {
+    u64x4 even = SHUFFLE(u64x4, *a, *b, 0, 2, 4, 6);
+    u64x4 odd = SHUFFLE(u64x4, *a, *b, 1, 3, 5, 7);
+    *a = even;
+    *b = odd;
+}
+
+static inline void merge_u64x4(u64x4* a, u64x4* b) {
+    u64x4 lo = SHUFFLE(u64x4, *a, *b, 0, 4, 1, 5);
+    u64x4 hi = SHUFFLE(u64x4, *a, *b, 2, 6, 3, 7);
+    *a = lo;
+    *b = hi;
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_EXTRA_VECTOR_H */
@@ -0,0 +1,100 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_GENERIC_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_GENERIC_H
+
+#include "bit_transpose.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Helpers for the backend independent functions, which select the function
+ * for k = 8/16/32/64/128 at runtime. */
+
+/* Transpose a kxk matrix in place. */
+static inline void transpose_bit_kxk_inplace(size_t k, void* matrix) {
+    switch (k) {
+        case 8:
+            transpose_bit_8x8_inplace(matrix);
+            break;
+        case 16:
+            transpose_bit_16x16_inplace(matrix);
+            break;
+        case 32:
+            transpose_bit_32x32_inplace(matrix);
+            break;
+        case 64:
+            transpose_bit_64x64_inplace(matrix);
+            break;
+        case 128:
+            transpose_bit_128x128_inplace(matrix);
+            break;
+    }
+}
+
+/* Transpose a kxN matrix given by row pointers. */
+static inline void transpose_bit_kxN_rows(size_t k, uint8_t* dst, const uint8_t* const* src,
+                                          size_t N) {
+    switch (k) {
+        case 8:
+            transpose_bit_8xN(dst, src, N);
+            break;
+        case 16:
+            transpose_bit_16xN((uint16_t*)(dst), src, N);
+            break;
+        case 32:
+            transpose_bit_32xN((uint32_t*)(dst), src, N);
+            break;
+        case 64:
+            transpose_bit_64xN((uint64_t*)(dst), src, N);
+            break;
+        case 128:
+            transpose_bit_128xN(dst, src, N);
+            break;
+    }
+}
+
+/* Transpose a Nxk matrix into rows given by pointers. */
+static inline void transpose_bit_Nxk_rows(size_t k, uint8_t** dst, const uint8_t* src,
+                                          size_t N) {
+    switch (k) {
+        case 8:
+            transpose_bit_Nx8(dst, src, N);
+            break;
+        case 16:
+            transpose_bit_Nx16(dst, (const uint16_t*)(src), N);
+            break;
+        case 32:
+            transpose_bit_Nx32(dst, (const uint32_t*)(src), N);
+            break;
+        case 64:
+            transpose_bit_Nx64(dst, (const uint64_t*)(src), N);
+            break;
+        case 128:
+            transpose_bit_Nx128(dst, src, N);
+            break;
+    }
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_GENERIC_H */
@@ -0,0 +1,69 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_PREFETCH_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_PREFETCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Helpers for prefetching the source rows of the kxN transpositions.  These
+ * read 64 or 128 rows at once, which are more streams than the hardware
+ * prefetchers track.  (Prefetching the destination rows of the Nxk
+ * transpositions turned out to slow them down.) */
+
+/* The rows are prefetched this many bytes ahead of the slice which is
+ * currently processed.  A distance of 0 disables the prefetching. */
+#ifndef BITTRANSPOSE_ROW_PREFETCH_DISTANCE
+#define BITTRANSPOSE_ROW_PREFETCH_DISTANCE 128
+#endif
+
+/* Prefetch the rows for reading.  The caller processes the slice of size bytes
+ * at offset of each row of length bytes, and the lines starting within this
+ * slice are requested ahead by the prefetch distance.  Thus, if the slices
+ * cover the rows from left to right, every line is requested exactly once. */
+static inline void prefetch_rows(const uint8_t* const* rows, size_t num_rows, size_t offset,
+                                 size_t size, size_t length) {
+#if defined(__GNUC__)
+    if (BITTRANSPOSE_ROW_PREFETCH_DISTANCE == 0) {
+        return;
+    }
+    for (size_t line = (offset + 63) & ~(size_t)(63); line < offset + size; line += 64) {
+        const size_t ahead = line + BITTRANSPOSE_ROW_PREFETCH_DISTANCE;
+        if (ahead >= length) {
+            return;
+        }
+        for (size_t i = 0; i < num_rows; ++i) {
+            __builtin_prefetch(rows[i] + ahead, 0, 2);
+        }
+    }
+#else
+    (void)rows;
+    (void)num_rows;
+    (void)offset;
+    (void)size;
+    (void)length;
+#endif
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_PREFETCH_H */
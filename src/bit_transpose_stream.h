@@ -0,0 +1,59 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITTRANSPOSE_BIT_TRANSPOSE_STREAM_H
+#define BITTRANSPOSE_BIT_TRANSPOSE_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Helpers for writing the output of the rectangular transpositions with
+ * non-temporal (streaming) stores. */
+
+/* Outputs of at least this many bytes are written with streaming stores, such
+ * that they do not evict the working set from the caches.  The default exceeds
+ * the last level cache of most desktop processors. */
+#ifndef BITTRANSPOSE_STREAMING_THRESHOLD
+#define BITTRANSPOSE_STREAMING_THRESHOLD ((size_t)(16) << 20)
+#endif
+
+/* Check if an output of the given size should be written with streaming stores. */
+static inline int use_streaming_stores(size_t size) {
+    return size >= (size_t)(BITTRANSPOSE_STREAMING_THRESHOLD);
+}
+
+/* Check if the pointer is aligned to the given power of two. */
+static inline int is_aligned_to(const void* ptr, size_t alignment) {
+    return ((uintptr_t)(ptr) & (alignment - 1)) == 0;
+}
+
+/* Check if all num_rows pointers are aligned to the given power of two. */
+static inline int rows_aligned_to(uint8_t* const* rows, size_t num_rows, size_t alignment) {
+    uintptr_t bits = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        bits |= (uintptr_t)(rows[i]);
+    }
+    return (bits & (alignment - 1)) == 0;
+}
+
+#endif /* BITTRANSPOSE_BIT_TRANSPOSE_STREAM_H */
@@ -0,0 +1,158 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Runtime dispatch between the backends.
+ *
+ * Each public function is an indirect function (ifunc) whose resolver is run
+ * by the dynamic loader (or the startup code for static executables) once,
+ * before any code of the program is executed.  The symbol is then bound
+ * directly to the implementation of the selected backend, so that calls do not
+ * pay for any additional checks.
+ */
+
+#include "bit_transpose.h"
+
+enum backend {
+    BACKEND_PLAIN,
+    BACKEND_SSSE3,
+    BACKEND_AVX2,
+    BACKEND_AVX2_GFNI,
+    BACKEND_AVX512,
+    BACKEND_AVX512_GFNI,
+};
+
+/* Resolvers run during relocation, before the sanitizer runtimes are set up,
+ * so they must not carry any sanitizer instrumentation.
+ */
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+#define NO_SANITIZE __attribute__((no_sanitize("address", "undefined")))
+#else
+#define NO_SANITIZE __attribute__((no_sanitize_address))
+#endif
+
+/* Resolvers run before constructors, so we need to initialize the CPU model
+ * data of libgcc ourselves.  __builtin_cpu_supports also checks that the OS
+ * saves the YMM and ZMM registers.
+ */
+NO_SANITIZE static enum backend select_backend(void) {
+    __builtin_cpu_init();
+    const int gfni = __builtin_cpu_supports("gfni");
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return gfni ? BACKEND_AVX512_GFNI : BACKEND_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return gfni ? BACKEND_AVX2_GFNI : BACKEND_AVX2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return BACKEND_SSSE3;
+    }
+    return BACKEND_PLAIN;
+}
+
+/* All public functions (keep in sync with bit_transpose_backend.h). */
+#define FOR_EACH_FUNCTION(X) \
+    X(transpose_bit_backend) \
+    X(transpose_bit_8x8_direct) \
+    X(transpose_bit_8x8_inplace) \
+    X(transpose_bit_8x8_packed_x4_inplace) \
+    X(transpose_bit_8x8_packed_x4_inplace_aligned) \
+    X(transpose_bit_16x16_inplace) \
+    X(transpose_bit_16x16_inplace_aligned) \
+    X(transpose_bit_32x32_inplace) \
+    X(transpose_bit_32x32_inplace_aligned) \
+    X(transpose_bit_64x64_inplace) \
+    X(transpose_bit_64x64_inplace_aligned) \
+    X(transpose_bit_128x128_inplace) \
+    X(transpose_bit_128x128_inplace_aligned) \
+    X(transpose_bit_8x8) \
+    X(transpose_bit_8x8_packed_x4) \
+    X(transpose_bit_8x8_packed_x4_aligned) \
+    X(transpose_bit_16x16) \
+    X(transpose_bit_16x16_aligned) \
+    X(transpose_bit_32x32) \
+    X(transpose_bit_32x32_aligned) \
+    X(transpose_bit_64x64) \
+    X(transpose_bit_64x64_aligned) \
+    X(transpose_bit_128x128) \
+    X(transpose_bit_128x128_aligned) \
+    X(transpose_bit_8x8_batch) \
+    X(transpose_bit_8x8_batch_inplace) \
+    X(transpose_bit_16x16_batch) \
+    X(transpose_bit_16x16_batch_inplace) \
+    X(transpose_bit_32x32_batch) \
+    X(transpose_bit_32x32_batch_inplace) \
+    X(transpose_bit_64x64_batch) \
+    X(transpose_bit_64x64_batch_inplace) \
+    X(transpose_bit_128x128_batch) \
+    X(transpose_bit_128x128_batch_inplace) \
+    X(transpose_bit_8xN) \
+    X(transpose_bit_Nx8) \
+    X(transpose_bit_16xN) \
+    X(transpose_bit_Nx16) \
+    X(transpose_bit_32xN) \
+    X(transpose_bit_Nx32) \
+    X(transpose_bit_64xN) \
+    X(transpose_bit_Nx64) \
+    X(transpose_bit_128xN) \
+    X(transpose_bit_Nx128) \
+    X(transpose_bit_8xN_aligned) \
+    X(transpose_bit_Nx8_aligned) \
+    X(transpose_bit_16xN_aligned) \
+    X(transpose_bit_Nx16_aligned) \
+    X(transpose_bit_32xN_aligned) \
+    X(transpose_bit_Nx32_aligned) \
+    X(transpose_bit_64xN_aligned) \
+    X(transpose_bit_Nx64_aligned) \
+    X(transpose_bit_128xN_aligned) \
+    X(transpose_bit_Nx128_aligned) \
+    X(transpose_bit_64xN_nt) \
+    X(transpose_bit_128xN_nt) \
+    X(transpose_bit_Nx128_nt)
+
+#define DEFINE_IFUNC(name) \
+    extern __typeof__(name) name##_plain; \
+    extern __typeof__(name) name##_ssse3; \
+    extern __typeof__(name) name##_avx2; \
+    extern __typeof__(name) name##_avx2_gfni; \
+    extern __typeof__(name) name##_avx512; \
+    extern __typeof__(name) name##_avx512_gfni; \
+    NO_SANITIZE static __typeof__(name)* name##_resolver(void) { \
+        switch (select_backend()) { \
+            case BACKEND_AVX512_GFNI: \
+                return name##_avx512_gfni; \
+            case BACKEND_AVX512: \
+                return name##_avx512; \
+            case BACKEND_AVX2_GFNI: \
+                return name##_avx2_gfni; \
+            case BACKEND_AVX2: \
+                return name##_avx2; \
+            case BACKEND_SSSE3: \
+                return name##_ssse3; \
+            default: \
+                return name##_plain; \
+        } \
+    } \
+    __typeof__(name) name __attribute__((ifunc(#name "_resolver")));
+
+FOR_EACH_FUNCTION(DEFINE_IFUNC)
@@ -0,0 +1,129 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose.h"
+#include "bit_transpose_generic.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Transposition of bit matrices of arbitrary size built on top of the kxN
+ * functions.  It does not depend on the backend and is compiled once. */
+
+/* The matrix is processed in blocks of MATRIX_BLOCK_SIZE x MATRIX_BLOCK_SIZE
+ * bits, so that the parts of the rows of src read and of the rows of dst
+ * written by a block span whole cache lines and stay in the (L2) cache while
+ * the block is processed.  Each block is split into bands of 128 rows, which
+ * are transposed into a buffer and copied to the rows of dst from there. */
+#define MATRIX_BLOCK_SIZE 1024
+#define MATRIX_BAND_SIZE 128
+
+/* The recursive variant subdivides the matrix until it consists of at most
+ * MATRIX_BAND_SIZE x MATRIX_TILE_SIZE bits, whose rows of src and dst fit
+ * into the L1 cache together. */
+#define MATRIX_TILE_SIZE 512
+
+/* Transposes the band of num_rows <= 128 rows starting at src into the columns
+ * of the num_cols rows starting at dst.  All bits after the first num_rows of
+ * the last byte written to each row of dst are preserved. */
+static void transpose_bit_band(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                               size_t src_stride, size_t num_rows, size_t num_cols) {
+    uint64_t staging_words[MATRIX_BLOCK_SIZE * MATRIX_BAND_SIZE / 64];
+    uint8_t* staging = (uint8_t*)(staging_words);
+    const uint8_t* src_rows[MATRIX_BAND_SIZE];
+    for (size_t i = 0; i < num_rows; ++i) {
+        src_rows[i] = src + i * src_stride;
+    }
+    if (num_rows == MATRIX_BAND_SIZE && num_cols % MATRIX_BAND_SIZE == 0) {
+        transpose_bit_kxN_rows(MATRIX_BAND_SIZE, staging, src_rows,
+                               num_cols / MATRIX_BAND_SIZE);
+        for (size_t j = 0; j < num_cols; ++j) {
+            memcpy(dst + j * dst_stride, staging + j * (MATRIX_BAND_SIZE / 8),
+                   MATRIX_BAND_SIZE / 8);
+        }
+        return;
+    }
+    /* ragged edge of the matrix */
+    transpose_bit_kxN(staging, src_rows, num_rows, num_cols);
+    const size_t row_size = (num_rows + 7) / 8;
+    const size_t num_bytes = num_rows / 8;
+    const uint8_t mask = (uint8_t)((1u << (num_rows % 8)) - 1);
+    for (size_t j = 0; j < num_cols; ++j) {
+        uint8_t* row = dst + j * dst_stride;
+        memcpy(row, staging + j * row_size, num_bytes);
+        if (mask != 0) {
+            const uint8_t bits = staging[j * row_size + num_bytes];
+            row[num_bytes] = (uint8_t)((row[num_bytes] & ~mask) | (bits & mask));
+        }
+    }
+}
+
+void transpose_bit_matrix(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                          size_t src_stride, size_t num_rows, size_t num_cols) {
+    for (size_t row = 0; row < num_rows; row += MATRIX_BLOCK_SIZE) {
+        const size_t block_rows = num_rows - row < MATRIX_BLOCK_SIZE ? num_rows - row
+                                                                     : MATRIX_BLOCK_SIZE;
+        for (size_t col = 0; col < num_cols; col += MATRIX_BLOCK_SIZE) {
+            const size_t block_cols = num_cols - col < MATRIX_BLOCK_SIZE
+                                          ? num_cols - col
+                                          : MATRIX_BLOCK_SIZE;
+            for (size_t band = 0; band < block_rows; band += MATRIX_BAND_SIZE) {
+                const size_t band_rows = block_rows - band < MATRIX_BAND_SIZE
+                                             ? block_rows - band
+                                             : MATRIX_BAND_SIZE;
+                transpose_bit_band(dst + col * dst_stride + (row + band) / 8, dst_stride,
+                                   src + (row + band) * src_stride + col / 8, src_stride,
+                                   band_rows, block_cols);
+            }
+        }
+    }
+}
+
+/* Splits n > MATRIX_BAND_SIZE into two parts, of which the first one is a
+ * multiple of MATRIX_BAND_SIZE bits. */
+static size_t split_point(size_t n) {
+    return (n / 2 + MATRIX_BAND_SIZE - 1) / MATRIX_BAND_SIZE * MATRIX_BAND_SIZE;
+}
+
+void transpose_bit_matrix_recursive(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                    size_t src_stride, size_t num_rows, size_t num_cols) {
+    if (num_rows <= MATRIX_BAND_SIZE && num_cols <= MATRIX_TILE_SIZE) {
+        if (num_rows != 0 && num_cols != 0) {
+            transpose_bit_band(dst, dst_stride, src, src_stride, num_rows, num_cols);
+        }
+        return;
+    }
+    /* halve the larger dimension */
+    if (num_rows >= num_cols) {
+        const size_t split = split_point(num_rows);
+        transpose_bit_matrix_recursive(dst, dst_stride, src, src_stride, split, num_cols);
+        transpose_bit_matrix_recursive(dst + split / 8, dst_stride, src + split * src_stride,
+                                       src_stride, num_rows - split, num_cols);
+    } else {
+        const size_t split = split_point(num_cols);
+        transpose_bit_matrix_recursive(dst, dst_stride, src, src_stride, num_rows, split);
+        transpose_bit_matrix_recursive(dst + split * dst_stride, dst_stride, src + split / 8,
+                                       src_stride, num_rows, num_cols - split);
+    }
+}
@@ -21,23 +21,94 @@
  * SOFTWARE.
  */
 
+#include "bit_transpose_backend.h"
 #include "bit_transpose.h"
 #include "bit_transpose_extra_avx2.h"
+#include "bit_transpose_prefetch.h"
+#include "bit_transpose_stream.h"
 
 #include <immintrin.h>
 #include <string.h>
 
+/* Number of 128x128 blocks which transpose_bit_Nx128 transposes at once (1, 2, 4, 8 or 16).  A
+ * super block occupies 4 KiB per block on the stack, so larger super blocks trade L1 residency
+ * for longer contiguous stores into the rows.  The default of 8 (a 32 KiB working set) was the
+ * fastest width for both the avx2 and the avx2_gfni backend in our measurements. */
+#ifdef BITTRANSPOSE_NX128_SUPER_BLOCK_SIZE
+#define NX128_SUPER_BLOCK_SIZE BITTRANSPOSE_NX128_SUPER_BLOCK_SIZE
+#else
+#define NX128_SUPER_BLOCK_SIZE 8
+#endif
+#if NX128_SUPER_BLOCK_SIZE != 1 && NX128_SUPER_BLOCK_SIZE != 2 && NX128_SUPER_BLOCK_SIZE != 4 && \
+    NX128_SUPER_BLOCK_SIZE != 8 && NX128_SUPER_BLOCK_SIZE != 16
+#error "BITTRANSPOSE_NX128_SUPER_BLOCK_SIZE must be one of 1, 2, 4, 8 or 16"
+#endif
+
+/* Transposes the 8x8 matrices of 16 bit words on each 128 bit lane of vec[0..7]. */
+static inline void transpose_epi16_8x8_x2(__m256i* vec) {
+    __m256i tmp[8];
+    for (size_t j = 0; j < 4; ++j) {
+        tmp[2 * j] = _mm256_unpacklo_epi16(vec[2 * j], vec[2 * j + 1]);
+        tmp[2 * j + 1] = _mm256_unpackhi_epi16(vec[2 * j], vec[2 * j + 1]);
+    }
+    for (size_t j = 0; j < 2; ++j) {
+        vec[4 * j + 0] = _mm256_unpacklo_epi32(tmp[4 * j + 0], tmp[4 * j + 2]);
+        vec[4 * j + 1] = _mm256_unpackhi_epi32(tmp[4 * j + 0], tmp[4 * j + 2]);
+        vec[4 * j + 2] = _mm256_unpacklo_epi32(tmp[4 * j + 1], tmp[4 * j + 3]);
+        vec[4 * j + 3] = _mm256_unpackhi_epi32(tmp[4 * j + 1], tmp[4 * j + 3]);
+    }
+    for (size_t j = 0; j < 4; ++j) {
+        tmp[2 * j] = _mm256_unpacklo_epi64(vec[j], vec[4 + j]);
+        tmp[2 * j + 1] = _mm256_unpackhi_epi64(vec[j], vec[4 + j]);
+    }
+    for (size_t j = 0; j < 8; ++j) {
+        vec[j] = tmp[j];
+    }
+}
+
 void transpose_bit_8xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
     /* shuffle / permutation masks used below */
     const __m256i shuffle_mask = _mm256_set_epi64x(0x0f0b07030e0a0602, 0x0d0905010c080400,
                                                    0x0f0b07030e0a0602, 0x0d0905010c080400);
     const __m256i permute_mask = _mm256_set_epi32(0x07, 0x03, 0x06, 0x02, 0x05, 0x01, 0x04, 0x00);
 
+    const __m256i wide_shuffle_mask = _mm256_set_epi64x(0x0f0d0b0907050301, 0x0e0c0a0806040200,
+                                                        0x0f0d0b0907050301, 0x0e0c0a0806040200);
+
     /* transposition of a 8xN matrix: */
     /* - partition the matrix into blocks of size 8x8 */
-    /* - process as many as possible in super blocks of 4 */
+    /* - process as many as possible in wide super blocks of 32 */
+    /* - process as many of the remaining ones as possible in super blocks of 4 */
+    size_t num_wide_super_blocks = N / 32;
+    for (size_t superblock_i = 0; superblock_i < num_wide_super_blocks; ++superblock_i) {
+        /* transpose 32 8x8 blocks */
+        __m256i vec[8];
+        /* load 32 words from each row */
+        for (size_t i = 0; i < 8; ++i) {
+            vec[i] = _mm256_loadu_si256((const __m256i*)(src[i] + 32 * superblock_i));
+        }
+        /* gather the 16 bit words of two consecutive blocks from all rows */
+        /* -> vec[j] contains blocks 2j, 2j+1 | 2j+16, 2j+17 */
+        transpose_epi16_8x8_x2(vec);
+        for (size_t j = 0; j < 8; ++j) {
+            /* deinterleave the bytes of the two blocks on each 128 bit lane */
+            /* [F7E6 D5C4 B3A2 9180] -> [FEDC BA98 7654 3210] */
+            vec[j] = _mm256_shuffle_epi8(vec[j], wide_shuffle_mask);
+            /* now each 64 bit word contains a 8x8 submatrix which we transpose separately */
+            vec[j] = transpose_bit_8x8_packed_x4_direct(vec[j]);
+        }
+        /* put the blocks into order again */
+        __m256i* dst_p = (__m256i*)(dst + 256 * superblock_i);
+        for (size_t j = 0; j < 4; ++j) {
+            _mm256_storeu_si256(&dst_p[j],
+                                _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0x20));
+            _mm256_storeu_si256(&dst_p[4 + j],
+                                _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0x31));
+        }
+    }
     size_t num_super_blocks = N / 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+    for (size_t superblock_i = 8 * num_wide_super_blocks; superblock_i < num_super_blocks;
+         ++superblock_i) {
         /* transpose 4 8x8 blocks */
         __m256i vec;
         /* load 4 words from each row */
@@ -71,17 +142,49 @@ void transpose_bit_8xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
     }
 }
 
-void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
+/* Transposes the 8x8 blocks with the packed 8x8 kernel. */
+static inline void transpose_bit_Nx8_packed(uint8_t** dst, const uint8_t* src, size_t N) {
     /* shuffle / permutation masks used below */
     const __m256i shuffle_mask = _mm256_set_epi64x(0x0f0b07030e0a0602, 0x0d0905010c080400,
                                                    0x0f0b07030e0a0602, 0x0d0905010c080400);
     const __m256i permute_mask = _mm256_set_epi32(0x07, 0x05, 0x03, 0x01, 0x06, 0x04, 0x02, 0x00);
 
-    /* transposition of a 8xN matrix: */
+    const __m256i wide_shuffle_mask = _mm256_set_epi64x(0x0f070e060d050c04, 0x0b030a0209010800,
+                                                        0x0f070e060d050c04, 0x0b030a0209010800);
+
+    /* transposition of a Nx8 matrix: */
     /* - partition the matrix into blocks of size 8x8 */
-    /* - process as many as possible in super blocks of 4 */
+    /* - process as many as possible in wide super blocks of 32 */
+    /* - process as many of the remaining ones as possible in super blocks of 4 */
+    size_t num_wide_super_blocks = N / 32;
+    for (size_t superblock_i = 0; superblock_i < num_wide_super_blocks; ++superblock_i) {
+        /* transpose 32 8x8 blocks */
+        const __m256i* src_p = (const __m256i*)(src + 256 * superblock_i);
+        __m256i vec[8];
+        /* load the blocks such that vec[j] contains blocks 2j, 2j+1 | 2j+16, 2j+17 */
+        for (size_t j = 0; j < 4; ++j) {
+            const __m256i lo = _mm256_loadu_si256(&src_p[j]);
+            const __m256i hi = _mm256_loadu_si256(&src_p[4 + j]);
+            vec[2 * j] = _mm256_permute2x128_si256(lo, hi, 0x20);
+            vec[2 * j + 1] = _mm256_permute2x128_si256(lo, hi, 0x31);
+        }
+        for (size_t j = 0; j < 8; ++j) {
+            /* each 64 bit word contains a 8x8 submatrix which we transpose separately */
+            vec[j] = transpose_bit_8x8_packed_x4_direct(vec[j]);
+            /* interleave the bytes of the two blocks on each 128 bit lane */
+            /* [FEDC BA98 7654 3210] -> [F7E6 D5C4 B3A2 9180] */
+            vec[j] = _mm256_shuffle_epi8(vec[j], wide_shuffle_mask);
+        }
+        /* gather the 16 bit words belonging to the same row */
+        transpose_epi16_8x8_x2(vec);
+        /* store 32 words into each row */
+        for (size_t i = 0; i < 8; ++i) {
+            _mm256_storeu_si256((__m256i*)(dst[i] + 32 * superblock_i), vec[i]);
+        }
+    }
     size_t num_super_blocks = N / 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+    for (size_t superblock_i = 8 * num_wide_super_blocks; superblock_i < num_super_blocks;
+         ++superblock_i) {
         /* transpose 4 8x8 blocks */
         /* load 4 blocks */
         __m256i vec;
@@ -116,7 +219,101 @@ void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
     }
 }
 
-void transpose_bit_16xN_onebyone(uint16_t* dst, const uint8_t* const* src, size_t N) {
+/* Transposes the 8x8 blocks bit plane by bit plane. */
+static inline void transpose_bit_Nx8_movemask(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* transposition of a Nx8 matrix: */
+    /* - each byte of src is a row of the matrix, so bit i of 32 consecutive bytes forms 4 bytes
+     *   of row i of the result */
+    /* - process as many 8x8 blocks as possible in super blocks of 4: shift bit i into the most
+     *   significant bit of each byte and collect those with movemask */
+    /* - process the remaining ones one by one */
+    uint8_t* rows[8];
+    for (size_t i = 0; i < 8; ++i) {
+        rows[i] = dst[i];
+    }
+    size_t num_super_blocks = N / 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        const __m256i vec = _mm256_loadu_si256((const __m256i*)(src + 32 * superblock_i));
+        for (size_t i = 0; i < 8; ++i) {
+            /* shift each plane from vec directly instead of shifting vec step by step, which
+             * would chain the movemasks */
+            const uint32_t plane = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(vec, 7 - i));
+            memcpy(rows[i] + 4 * superblock_i, &plane, 4);
+        }
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 4 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block;
+        memcpy(&block, &src[8 * block_i], 8);
+        block = transpose_bit_8x8_direct(block);
+        for (size_t i = 0; i < 8; ++i) {
+            dst[i][block_i] = (block >> (i * 8)) & 0xff;
+        }
+    }
+}
+
+void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
+#ifdef __GFNI__
+    /* the GFNI 8x8 kernel outruns eight movemasks per 32 bytes */
+    transpose_bit_Nx8_packed(dst, src, N);
+#else
+    /* movemask avoids the shuffles and cross-lane permutations around the packed 8x8 kernel */
+    transpose_bit_Nx8_movemask(dst, src, N);
+#endif
+}
+
+/* Loads the first size < 8 bytes at src into the low bytes of a 64 bit word. */
+static inline uint64_t load_partial_u64(const uint8_t* src, size_t size) {
+    uint64_t word = 0;
+    size_t pos = 0;
+    if (size & 4) {
+        uint32_t part;
+        memcpy(&part, src, 4);
+        word = part;
+        pos = 4;
+    }
+    if (size & 2) {
+        uint16_t part;
+        memcpy(&part, src + pos, 2);
+        word |= (uint64_t)(part) << (8 * pos);
+        pos += 2;
+    }
+    if (size & 1) {
+        word |= (uint64_t)(src[pos]) << (8 * pos);
+    }
+    return word;
+}
+
+/* Stores the low size < 8 bytes of a 64 bit word to dst. */
+static inline void store_partial_u64(uint8_t* dst, uint64_t word, size_t size) {
+    size_t pos = 0;
+    if (size & 4) {
+        const uint32_t part = (uint32_t)(word);
+        memcpy(dst, &part, 4);
+        pos = 4;
+    }
+    if (size & 2) {
+        const uint16_t part = (uint16_t)(word >> (8 * pos));
+        memcpy(dst + pos, &part, 2);
+        pos += 2;
+    }
+    if (size & 1) {
+        dst[pos] = (uint8_t)(word >> (8 * pos));
+    }
+}
+
+/* Returns a mask selecting the first n 32 bit words of a 128 bit vector. */
+static inline __m128i first_epi32_mask(int n) {
+    return _mm_cmpgt_epi32(_mm_set1_epi32(n), _mm_set_epi32(3, 2, 1, 0));
+}
+
+/* The superblock functions below transpose num_blocks <= 4 consecutive blocks.
+ * For a partial super block (num_blocks < 4), only the words of the existing
+ * blocks are loaded and stored, and the missing ones are padded with zeros.
+ * This pays off for two or three remaining blocks, while a single one is
+ * cheaper to transpose on its own. */
+
+static void transpose_bit_16xN_onebyone(uint16_t* dst, const uint8_t* const* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 16xN matrix: */
@@ -133,72 +330,92 @@ void transpose_bit_16xN_onebyone(uint16_t* dst, const uint8_t* const* src, size_
     }
 }
 
-void transpose_bit_16xN(uint16_t* dst, const uint8_t* const* src, size_t N) {
-    /* batched implementation */
-
+static inline void transpose_bit_16xN_superblock(uint16_t* dst, const uint8_t* const* src,
+                                                 size_t offset, const size_t num_blocks) {
     /* shuffle / permutation masks used below */
     const __m256i shuffle_mask = _mm256_set_epi64x(0x0f0e07060d0c0504, 0x0b0a030209080100,
                                                    0x0f0e07060d0c0504, 0x0b0a030209080100);
     const __m256i permute_mask = _mm256_set_epi32(0x07, 0x03, 0x06, 0x02, 0x05, 0x01, 0x04, 0x00);
 
+    /* transpose 4 16x16 blocks */
+    __m256i vec[4];
+    __m256i tmp[4];
+    /* load 4 words from each row */
+    for (size_t j = 0; j < 4; ++j) {
+        if (num_blocks == 4) {
+            memcpy((uint8_t*)(&vec[j]), src[4 * j + 0] + offset, 8);
+            memcpy((uint8_t*)(&vec[j]) + 8, src[4 * j + 1] + offset, 8);
+            memcpy((uint8_t*)(&vec[j]) + 16, src[4 * j + 2] + offset, 8);
+            memcpy((uint8_t*)(&vec[j]) + 24, src[4 * j + 3] + offset, 8);
+        } else {
+            const size_t size = 2 * num_blocks;
+            const uint64_t word_0 = load_partial_u64(src[4 * j + 0] + offset, size);
+            const uint64_t word_1 = load_partial_u64(src[4 * j + 1] + offset, size);
+            const uint64_t word_2 = load_partial_u64(src[4 * j + 2] + offset, size);
+            const uint64_t word_3 = load_partial_u64(src[4 * j + 3] + offset, size);
+            vec[j] = _mm256_set_epi64x((long long)(word_3), (long long)(word_2),
+                                       (long long)(word_1), (long long)(word_0));
+        }
+    }
+    // interleave the 16 bit words of the two 64 bit block on each 128 bit lane
+    // [FEDC BA98 7654 3210] -> [FE76 DC54 BA32 9810]
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_shuffle_epi8(vec[j], shuffle_mask);
+    }
+    /* permute 32 bit words across lanes */
+    /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 3333 6666 2222 | 5555 1111 4444
+     * 0000] */
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
+    }
+
+    /* now each 64 bit word the quarter of a 16x16 submatrix */
+    /* - vec[0] contains the first 4 rows, vec[1] the second 4, and so on */
+    tmp[0] = _mm256_permute2x128_si256(vec[0], vec[1], 0b00100000);
+    tmp[1] = _mm256_permute2x128_si256(vec[0], vec[1], 0b00110001);
+    tmp[2] = _mm256_permute2x128_si256(vec[2], vec[3], 0b00100000);
+    tmp[3] = _mm256_permute2x128_si256(vec[2], vec[3], 0b00110001);
+    /* swap the middle 64 bit words across lanes */
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
+    }
+    tmp[0] = _mm256_permute2x128_si256(vec[0], vec[2], 0b00100000);
+    tmp[1] = _mm256_permute2x128_si256(vec[0], vec[2], 0b00110001);
+    tmp[2] = _mm256_permute2x128_si256(vec[1], vec[3], 0b00100000);
+    tmp[3] = _mm256_permute2x128_si256(vec[1], vec[3], 0b00110001);
+
+    for (size_t j = 0; j < num_blocks; ++j) {
+        tmp[j] = transpose_bit_16x16_direct(tmp[j]);
+        _mm256_storeu_si256((__m256i*)(dst + 16 * j), tmp[j]);
+    }
+}
+
+void transpose_bit_16xN(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* batched implementation */
+
     /* transposition of a 16xN matrix: */
     /* - partition the matrix into blocks of size 16x16 */
     /* - process as many as possible in super blocks of 4 */
+    /* - process the remaining ones in a partial super block, unless there is only one */
     size_t num_super_blocks = N / 4;
     size_t num_rest = N % 4;
     for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        /* transpose 4 16x16 blocks */
-        __m256i vec[4];
-        __m256i tmp[4];
-        /* load 4 words from each row */
-        for (size_t j = 0; j < 4; ++j) {
-            memcpy((uint8_t*)(&vec[j]), src[4 * j + 0] + 8 * superblock_i, 8);
-            memcpy((uint8_t*)(&vec[j]) + 8, src[4 * j + 1] + 8 * superblock_i, 8);
-            memcpy((uint8_t*)(&vec[j]) + 16, src[4 * j + 2] + 8 * superblock_i, 8);
-            memcpy((uint8_t*)(&vec[j]) + 24, src[4 * j + 3] + 8 * superblock_i, 8);
-        }
-        // interleave the 16 bit words of the two 64 bit block on each 128 bit lane
-        // [FEDC BA98 7654 3210] -> [FE76 DC54 BA32 9810]
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_shuffle_epi8(vec[j], shuffle_mask);
-        }
-        /* permute 32 bit words across lanes */
-        /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 3333 6666 2222 | 5555 1111 4444
-         * 0000] */
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
-        }
-
-        /* now each 64 bit word the quarter of a 16x16 submatrix */
-        /* - vec[0] contains the first 4 rows, vec[1] the second 4, and so on */
-        tmp[0] = _mm256_permute2x128_si256(vec[0], vec[1], 0b00100000);
-        tmp[1] = _mm256_permute2x128_si256(vec[0], vec[1], 0b00110001);
-        tmp[2] = _mm256_permute2x128_si256(vec[2], vec[3], 0b00100000);
-        tmp[3] = _mm256_permute2x128_si256(vec[2], vec[3], 0b00110001);
-        /* swap the middle 64 bit words across lanes */
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
-        }
-        tmp[0] = _mm256_permute2x128_si256(vec[0], vec[2], 0b00100000);
-        tmp[1] = _mm256_permute2x128_si256(vec[0], vec[2], 0b00110001);
-        tmp[2] = _mm256_permute2x128_si256(vec[1], vec[3], 0b00100000);
-        tmp[3] = _mm256_permute2x128_si256(vec[1], vec[3], 0b00110001);
-
-        for (size_t j = 0; j < 4; ++j) {
-            tmp[j] = transpose_bit_16x16_direct(tmp[j]);
-        }
-        memcpy(&dst[4 * superblock_i * 16], &tmp, 4 * 32);
+        transpose_bit_16xN_superblock(dst + 4 * superblock_i * 16, src, 8 * superblock_i, 4);
     }
-    /* process the remaining 16x16 blocks */
-    uint16_t* rest_dst = dst + 4 * num_super_blocks * 16;
-    const uint8_t* rest_src[16];
-    for (size_t i = 0; i < 16; ++i) {
-        rest_src[i] = src[i] + 2 * 4 * num_super_blocks;
+    if (num_rest == 1) {
+        uint16_t* rest_dst = dst + 4 * num_super_blocks * 16;
+        const uint8_t* rest_src[16];
+        for (size_t i = 0; i < 16; ++i) {
+            rest_src[i] = src[i] + 2 * 4 * num_super_blocks;
+        }
+        transpose_bit_16xN_onebyone(rest_dst, rest_src, num_rest);
+    } else if (num_rest != 0) {
+        transpose_bit_16xN_superblock(dst + 4 * num_super_blocks * 16, src, 8 * num_super_blocks,
+                                      num_rest);
     }
-    transpose_bit_16xN_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_Nx16_onebyone(uint8_t** dst, const uint16_t* src, size_t N) {
+static void transpose_bit_Nx16_onebyone(uint8_t** dst, const uint16_t* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 16xN matrix: */
@@ -215,72 +432,98 @@ void transpose_bit_Nx16_onebyone(uint8_t** dst, const uint16_t* src, size_t N) {
     }
 }
 
-void transpose_bit_Nx16(uint8_t** dst, const uint16_t* src, size_t N) {
-    /* batched implementation */
-
+static inline void transpose_bit_Nx16_superblock(uint8_t** dst, size_t offset,
+                                                 const uint16_t* src, const size_t num_blocks) {
     /* shuffle / permutation masks used below */
     const __m256i shuffle_mask = _mm256_set_epi64x(0x0f0e0b0a07060302, 0x0d0c090805040100,
                                                    0x0f0e0b0a07060302, 0x0d0c090805040100);
     const __m256i permute_mask = _mm256_set_epi32(0x07, 0x05, 0x03, 0x01, 0x06, 0x04, 0x02, 0x00);
 
-    /* transposition of a 16xN matrix: */
-    /* - partition the matrix into blocks of size 16x16 */
-    /* - process as many as possible in super blocks of 4 */
-    size_t num_super_blocks = N / 4;
-    size_t num_rest = N % 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        /* transpose 4 16x16 blocks */
-        __m256i vec[4];
-        __m256i tmp[4];
-        /* load 4 16x16 matrices and transpose them */
-        memcpy(tmp, &src[4 * superblock_i * 16], 4 * 32);
-        for (size_t j = 0; j < 4; ++j) {
+    /* transpose 4 16x16 blocks */
+    __m256i vec[4];
+    __m256i tmp[4];
+    /* load 4 16x16 matrices and transpose them */
+    for (size_t j = 0; j < 4; ++j) {
+        if (j < num_blocks) {
+            tmp[j] = _mm256_loadu_si256((const __m256i*)(src + 16 * j));
             tmp[j] = transpose_bit_16x16_direct(tmp[j]);
+        } else {
+            tmp[j] = _mm256_setzero_si256();
         }
-        vec[0] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00100000);
-        vec[2] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00110001);
-        vec[1] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00100000);
-        vec[3] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00110001);
+    }
+    vec[0] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00100000);
+    vec[2] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00110001);
+    vec[1] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00100000);
+    vec[3] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00110001);
 
-        /* swap the middle 64 bit words across lanes */
-        for (size_t j = 0; j < 4; ++j) {
-            tmp[j] = _mm256_permute4x64_epi64(vec[j], 0b11011000);
-        }
+    /* swap the middle 64 bit words across lanes */
+    for (size_t j = 0; j < 4; ++j) {
+        tmp[j] = _mm256_permute4x64_epi64(vec[j], 0b11011000);
+    }
 
-        vec[0] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00100000);
-        vec[1] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00110001);
-        vec[2] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00100000);
-        vec[3] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00110001);
+    vec[0] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00100000);
+    vec[1] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00110001);
+    vec[2] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00100000);
+    vec[3] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00110001);
 
-        /* permute 32 bit words across lanes */
-        /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 5555 3333 1111 | 6666 4444 2222
-         * 0000] */
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
-        }
-        /* deinterleave the 16 bit words of the two 64 bit block on each 128 bit lane */
-        /* [FEDC BA98 7654 3210] -> [FEBA 7632 DC98 5410] */
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_shuffle_epi8(vec[j], shuffle_mask);
-        }
-        /* store 4 words into each row */
-        for (size_t j = 0; j < 4; ++j) {
-            memcpy(dst[4 * j + 0] + 8 * superblock_i, (uint8_t*)(&vec[j]), 8);
-            memcpy(dst[4 * j + 1] + 8 * superblock_i, (uint8_t*)(&vec[j]) + 8, 8);
-            memcpy(dst[4 * j + 2] + 8 * superblock_i, (uint8_t*)(&vec[j]) + 16, 8);
-            memcpy(dst[4 * j + 3] + 8 * superblock_i, (uint8_t*)(&vec[j]) + 24, 8);
+    /* permute 32 bit words across lanes */
+    /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 5555 3333 1111 | 6666 4444 2222
+     * 0000] */
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
+    }
+    /* deinterleave the 16 bit words of the two 64 bit block on each 128 bit lane */
+    /* [FEDC BA98 7654 3210] -> [FEBA 7632 DC98 5410] */
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_shuffle_epi8(vec[j], shuffle_mask);
+    }
+    /* store 4 words into each row */
+    for (size_t j = 0; j < 4; ++j) {
+        if (num_blocks == 4) {
+            memcpy(dst[4 * j + 0] + offset, (uint8_t*)(&vec[j]), 8);
+            memcpy(dst[4 * j + 1] + offset, (uint8_t*)(&vec[j]) + 8, 8);
+            memcpy(dst[4 * j + 2] + offset, (uint8_t*)(&vec[j]) + 16, 8);
+            memcpy(dst[4 * j + 3] + offset, (uint8_t*)(&vec[j]) + 24, 8);
+        } else {
+            const size_t size = 2 * num_blocks;
+            store_partial_u64(dst[4 * j + 0] + offset, (uint64_t)(_mm256_extract_epi64(vec[j], 0)),
+                              size);
+            store_partial_u64(dst[4 * j + 1] + offset, (uint64_t)(_mm256_extract_epi64(vec[j], 1)),
+                              size);
+            store_partial_u64(dst[4 * j + 2] + offset, (uint64_t)(_mm256_extract_epi64(vec[j], 2)),
+                              size);
+            store_partial_u64(dst[4 * j + 3] + offset, (uint64_t)(_mm256_extract_epi64(vec[j], 3)),
+                              size);
         }
     }
-    /* process the remaining 16x16 blocks */
-    const uint16_t* rest_src = src + 4 * num_super_blocks * 16;
-    uint8_t* rest_dst[16];
-    for (size_t i = 0; i < 16; ++i) {
-        rest_dst[i] = dst[i] + 2 * 4 * num_super_blocks;
+}
+
+void transpose_bit_Nx16(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* batched implementation */
+
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 4 */
+    /* - process the remaining ones in a partial super block, unless there is only one */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        transpose_bit_Nx16_superblock(dst, 8 * superblock_i, src + 4 * superblock_i * 16, 4);
+    }
+    if (num_rest == 1) {
+        const uint16_t* rest_src = src + 4 * num_super_blocks * 16;
+        uint8_t* rest_dst[16];
+        for (size_t i = 0; i < 16; ++i) {
+            rest_dst[i] = dst[i] + 2 * 4 * num_super_blocks;
+        }
+        transpose_bit_Nx16_onebyone(rest_dst, rest_src, num_rest);
+    } else if (num_rest != 0) {
+        transpose_bit_Nx16_superblock(dst, 8 * num_super_blocks, src + 4 * num_super_blocks * 16,
+                                      num_rest);
     }
-    transpose_bit_Nx16_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_32xN_onebyone(uint32_t* dst, const uint8_t* const* src, size_t N) {
+static void transpose_bit_32xN_onebyone(uint32_t* dst, const uint8_t* const* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 32xN matrix: */
@@ -295,81 +538,121 @@ void transpose_bit_32xN_onebyone(uint32_t* dst, const uint8_t* const* src, size_
     }
 }
 
-void transpose_bit_32xN(uint32_t* dst, const uint8_t* const* src, size_t N) {
-    /* batched implementation */
+/* Loads the rows of a 32xN super block into vec[0..15]. */
+static inline void transpose_bit_32xN_load(__m256i* vec, const uint8_t* const* src, size_t offset,
+                                           const size_t num_blocks) {
+    /* load 4 words from each row */
+    for (size_t j = 0; j < 16; ++j) {
+        if (num_blocks == 4) {
+            memcpy((uint8_t*)(&vec[j]), src[2 * j] + offset, 16);
+            memcpy((uint8_t*)(&vec[j]) + 16, src[2 * j + 1] + offset, 16);
+        } else {
+            const __m128i mask = first_epi32_mask((int)(num_blocks));
+            const __m128i lo = _mm_maskload_epi32((const int*)(src[2 * j] + offset), mask);
+            const __m128i hi = _mm_maskload_epi32((const int*)(src[2 * j + 1] + offset), mask);
+            vec[j] = _mm256_set_m128i(hi, lo);
+        }
+    }
+}
 
+/* Transposes the 32xN super block loaded into vec[0..15] and stores it. */
+static inline void transpose_bit_32xN_store(uint32_t* dst, __m256i* vec, const size_t num_blocks) {
     /* permutation mask used below */
     const __m256i permute_mask = _mm256_set_epi32(0x07, 0x03, 0x06, 0x02, 0x05, 0x01, 0x04, 0x00);
 
+    /* transpose 4 32x32 blocks */
+    __m256i tmp[16];
+    /* interleave the 32 bit words across the two 128 bit lanes */
+    /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 3333 6666 2222 | 5555 1111 4444
+     * 0000] */
+    for (size_t j = 0; j < 16; ++j) {
+        vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
+    }
+    /* now each 64 bits belong together, so a 256 bit register looks like this */
+    /* [BBBB AAAA BBBB AAAA | BBBB AAAA BBBB AAAA] where, AAAA/BBBB belong to the same row resp.
+     */
+
+    for (size_t j = 0; j < 8; ++j) {
+        tmp[2 * j + 0] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00100000);
+        tmp[2 * j + 1] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00110001);
+    }
+    /* now [DDDD CCCC DDDD CCCC | BBBB AAAA BBBB AAAA] where, A/B/C/D belong to the same row
+     * resp. */
+    /* interleave the 32 bit words across the two 128 bit lanes */
+    /* [7777-6666 5555-4444 | 3333-2222 1111-0000] -> [7777-6666 3333-2222 | 5555-4444
+     * 1111-0000] */
+    for (size_t j = 0; j < 16; ++j) {
+        tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
+    }
+    /* now [DDDD CCCC BBBB AAAA | DDDD CCCC BBBB AAAA] where, A/B/C/D belong to the same row
+     * resp. */
+    /* and the whole state looks like this: */
+    /* [DCBA DCBA] [DCBA DCBA] [HGFE HGFE] [HGFE HGFE] [LKJI LKJI] [LKJI LKJI] [PONM PONM] [PONM
+     * PONM] */
+    /* [TSRQ TSRQ] [TSRQ TSRQ] [XWVU XWVU] [XWVU XWVU] [baZY baZY] [baZY baZY] [fedc fedc] [fedc
+     * fedc] */
+    for (size_t j = 0; j < 4; ++j) {
+        vec[j] = _mm256_permute2x128_si256(tmp[4 * j], tmp[4 * j + 2], 0b00100000);
+        vec[4 + j] = _mm256_permute2x128_si256(tmp[4 * j], tmp[4 * j + 2], 0b00110001);
+        vec[8 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00100000);
+        vec[12 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00110001);
+    }
+    /* now each four 256 bit words contain one 32x32 matrix which we can transpose: */
+    /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
+     * baZY] */
+    /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
+     * baZY] */
+    for (size_t j = 0; j < num_blocks; ++j) {
+        transpose_bit_32x32_inplace_aligned(&vec[4 * j]);
+    }
+    for (size_t j = 0; j < 4 * num_blocks; ++j) {
+        _mm256_storeu_si256((__m256i*)(dst + 8 * j), vec[j]);
+    }
+}
+
+static inline void transpose_bit_32xN_superblock(uint32_t* dst, const uint8_t* const* src,
+                                                 size_t offset, const size_t num_blocks) {
+    __m256i vec[16];
+    transpose_bit_32xN_load(vec, src, offset, num_blocks);
+    transpose_bit_32xN_store(dst, vec, num_blocks);
+}
+
+void transpose_bit_32xN(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    /* batched implementation */
+
     /* transposition of a 32xN matrix: */
     /* - partition the matrix into blocks of size 32x32 */
-    /* - process as many as possible in super blocks of 4 */
+    /* - process as many as possible in super blocks of 4, loading the rows of the next super
+     *   block before the current one is transposed */
+    /* - process the remaining ones in a partial super block, unless there is only one */
     size_t num_super_blocks = N / 4;
     size_t num_rest = N % 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        /* transpose 4 16x16 blocks */
-        __m256i vec[16];
-        __m256i tmp[16];
-        /* load 4 words from each row */
-        for (size_t j = 0; j < 16; ++j) {
-            memcpy((uint8_t*)(&vec[j]), src[2 * j] + 16 * superblock_i, 16);
-            memcpy((uint8_t*)(&vec[j]) + 16, src[2 * j + 1] + 16 * superblock_i, 16);
-        }
-        /* interleave the 32 bit words across the two 128 bit lanes */
-        /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 3333 6666 2222 | 5555 1111 4444
-         * 0000] */
-        for (size_t j = 0; j < 16; ++j) {
-            vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
-        }
-        /* now each 64 bits belong together, so a 256 bit register looks like this */
-        /* [BBBB AAAA BBBB AAAA | BBBB AAAA BBBB AAAA] where, AAAA/BBBB belong to the same row resp.
-         */
-
-        for (size_t j = 0; j < 8; ++j) {
-            tmp[2 * j + 0] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00100000);
-            tmp[2 * j + 1] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00110001);
-        }
-        /* now [DDDD CCCC DDDD CCCC | BBBB AAAA BBBB AAAA] where, A/B/C/D belong to the same row
-         * resp. */
-        /* interleave the 32 bit words across the two 128 bit lanes */
-        /* [7777-6666 5555-4444 | 3333-2222 1111-0000] -> [7777-6666 3333-2222 | 5555-4444
-         * 1111-0000] */
-        for (size_t j = 0; j < 16; ++j) {
-            tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
-        }
-        /* now [DDDD CCCC BBBB AAAA | DDDD CCCC BBBB AAAA] where, A/B/C/D belong to the same row
-         * resp. */
-        /* and the whole state looks like this: */
-        /* [DCBA DCBA] [DCBA DCBA] [HGFE HGFE] [HGFE HGFE] [LKJI LKJI] [LKJI LKJI] [PONM PONM] [PONM
-         * PONM] */
-        /* [TSRQ TSRQ] [TSRQ TSRQ] [XWVU XWVU] [XWVU XWVU] [baZY baZY] [baZY baZY] [fedc fedc] [fedc
-         * fedc] */
-        for (size_t j = 0; j < 4; ++j) {
-            vec[j] = _mm256_permute2x128_si256(tmp[4 * j], tmp[4 * j + 2], 0b00100000);
-            vec[4 + j] = _mm256_permute2x128_si256(tmp[4 * j], tmp[4 * j + 2], 0b00110001);
-            vec[8 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00100000);
-            vec[12 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00110001);
-        }
-        /* now each four 256 bit words contain one 32x32 matrix which we can transpose: */
-        /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
-         * baZY] */
-        /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
-         * baZY] */
-        for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_32x32_inplace_aligned(&vec[4 * j]);
+    if (num_super_blocks > 0) {
+        __m256i vec[2][16];
+        transpose_bit_32xN_load(vec[0], src, 0, 4);
+        for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+            __m256i* current = vec[superblock_i % 2];
+            if (superblock_i + 1 < num_super_blocks) {
+                transpose_bit_32xN_load(vec[(superblock_i + 1) % 2], src, 16 * (superblock_i + 1),
+                                        4);
+            }
+            transpose_bit_32xN_store(dst + 4 * superblock_i * 32, current, 4);
         }
-        memcpy(&dst[128 * superblock_i], &vec, 16 * 32);
     }
-    /* process the remaining 32x32 blocks */
-    uint32_t* rest_dst = dst + 4 * num_super_blocks * 32;
-    const uint8_t* rest_src[32];
-    for (size_t i = 0; i < 32; ++i) {
-        rest_src[i] = src[i] + 4 * 4 * num_super_blocks;
+    if (num_rest == 1) {
+        uint32_t* rest_dst = dst + 4 * num_super_blocks * 32;
+        const uint8_t* rest_src[32];
+        for (size_t i = 0; i < 32; ++i) {
+            rest_src[i] = src[i] + 4 * 4 * num_super_blocks;
+        }
+        transpose_bit_32xN_onebyone(rest_dst, rest_src, num_rest);
+    } else if (num_rest != 0) {
+        transpose_bit_32xN_superblock(dst + 4 * num_super_blocks * 32, src, 16 * num_super_blocks,
+                                      num_rest);
     }
-    transpose_bit_32xN_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
+static void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 32xN matrix: */
@@ -377,8 +660,7 @@ void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
     for (size_t block_i = 0; block_i < N; ++block_i) {
         /* transpose 32x32 blocks */
         __m256i vec[4];
-        memcpy(vec, src + block_i * 32, 128);
-        transpose_bit_32x32_inplace_aligned(vec);
+        transpose_bit_32x32(vec, src + block_i * 32);
         /* store a word into each row */
         for (size_t j = 0; j < 32; ++j) {
             memcpy(dst[j] + 4 * block_i, (uint8_t*)(&vec) + 4 * j, 4);
@@ -386,79 +668,99 @@ void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
     }
 }
 
+static inline void transpose_bit_Nx32_superblock(uint8_t** dst, size_t offset,
+                                                 const uint32_t* src, const size_t num_blocks) {
+    /* transpose 4 32x32 blocks */
+    __m256i vec[16];
+    __m256i tmp[16];
+    /* load four 32x32 matrices */
+    for (size_t j = 0; j < 16; ++j) {
+        vec[j] = j < 4 * num_blocks ? _mm256_loadu_si256((const __m256i*)(src + 8 * j))
+                                    : _mm256_setzero_si256();
+    }
+    /* and transpose them in place */
+    for (size_t j = 0; j < num_blocks; ++j) {
+        transpose_bit_32x32_inplace_aligned(&vec[4 * j]);
+    }
+    /* now do the reverse permutations of those in the 32xN case: */
+
+    /* first, transform the state from this */
+    /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
+     * baZY] */
+    /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
+     * baZY] */
+    /* to this */
+    /* [DCBA DCBA] [DCBA DCBA] [HGFE HGFE] [HGFE HGFE] [LKJI LKJI] [LKJI LKJI] [PONM PONM] [PONM
+     * PONM] */
+    /* [TSRQ TSRQ] [TSRQ TSRQ] [XWVU XWVU] [XWVU XWVU] [baZY baZY] [baZY baZY] [fedc fedc] [fedc
+     * fedc] */
+    for (size_t j = 0; j < 4; ++j) {
+        tmp[4 * j + 0] = _mm256_permute2x128_si256(vec[j], vec[4 + j], 0b00100000);
+        tmp[4 * j + 1] = _mm256_permute2x128_si256(vec[8 + j], vec[12 + j], 0b00100000);
+        tmp[4 * j + 2] = _mm256_permute2x128_si256(vec[j], vec[4 + j], 0b00110001);
+        tmp[4 * j + 3] = _mm256_permute2x128_si256(vec[8 + j], vec[12 + j], 0b00110001);
+    }
+    /* interleave the 32 bit words across the two 128 bit lanes */
+    /* [7777-6666 5555-4444 | 3333-2222 1111-0000] -> [7777-6666 3333-2222 | 5555-4444
+     * 1111-0000] */
+    for (size_t j = 0; j < 16; ++j) {
+        tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
+    }
+    /* now we have [DCDC BABA] [DCDC BABA] [HGHG FEFE] [HGHG FEFE] ... */
+    for (size_t j = 0; j < 8; ++j) {
+        vec[2 * j + 0] = _mm256_permute2x128_si256(tmp[2 * j], tmp[2 * j + 1], 0b00100000);
+        vec[2 * j + 1] = _mm256_permute2x128_si256(tmp[2 * j], tmp[2 * j + 1], 0b00110001);
+    }
+    /* now we have [BABA BABA] [DCDC DCDC] [FEFE FEFE] [HGHG HGHG] ... */
+    /* deinterleave the 32 bit words across the two 128 bit lanes */
+    /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 5555 3333 1111 | 6666 4444 2222
+     * 0000] */
+    const __m256i permute_mask =
+        _mm256_set_epi32(0x07, 0x05, 0x03, 0x01, 0x06, 0x04, 0x02, 0x00);
+    for (size_t j = 0; j < 16; ++j) {
+        vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
+    }
+
+    /* store 4 words into each row */
+    for (size_t j = 0; j < 16; ++j) {
+        if (num_blocks == 4) {
+            memcpy(dst[2 * j] + offset, (uint8_t*)(&vec[j]), 16);
+            memcpy(dst[2 * j + 1] + offset, (uint8_t*)(&vec[j]) + 16, 16);
+        } else {
+            const __m128i mask = first_epi32_mask((int)(num_blocks));
+            _mm_maskstore_epi32((int*)(dst[2 * j] + offset), mask, _mm256_castsi256_si128(vec[j]));
+            _mm_maskstore_epi32((int*)(dst[2 * j + 1] + offset), mask,
+                                _mm256_extracti128_si256(vec[j], 1));
+        }
+    }
+}
+
 void transpose_bit_Nx32(uint8_t** dst, const uint32_t* src, size_t N) {
     /* batched implementation */
 
-    /* transposition of a 16xN matrix: */
-    /* - partition the matrix into blocks of size 16x16 */
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
     /* - process as many as possible in super blocks of 4 */
+    /* - process the remaining ones in a partial super block, unless there is only one */
     size_t num_super_blocks = N / 4;
     size_t num_rest = N % 4;
     for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        /* transpose 4 32x32 blocks */
-        __m256i vec[16];
-        __m256i tmp[16];
-        /* load four 32x32 matrices */
-        memcpy(vec, &src[128 * superblock_i], 16 * 32);
-        /* and transpose them in place */
-        for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_32x32_inplace_aligned(&vec[4 * j]);
-        }
-        /* now do the reverse permutations of those in the 32xN case: */
-
-        /* first, transform the state from this */
-        /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
-         * baZY] */
-        /* [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc baZY] [HGFE DCBA] [PONM LKJI] [XWVU TSRQ] [fedc
-         * baZY] */
-        /* to this */
-        /* [DCBA DCBA] [DCBA DCBA] [HGFE HGFE] [HGFE HGFE] [LKJI LKJI] [LKJI LKJI] [PONM PONM] [PONM
-         * PONM] */
-        /* [TSRQ TSRQ] [TSRQ TSRQ] [XWVU XWVU] [XWVU XWVU] [baZY baZY] [baZY baZY] [fedc fedc] [fedc
-         * fedc] */
-        for (size_t j = 0; j < 4; ++j) {
-            tmp[4 * j + 0] = _mm256_permute2x128_si256(vec[j], vec[4 + j], 0b00100000);
-            tmp[4 * j + 1] = _mm256_permute2x128_si256(vec[8 + j], vec[12 + j], 0b00100000);
-            tmp[4 * j + 2] = _mm256_permute2x128_si256(vec[j], vec[4 + j], 0b00110001);
-            tmp[4 * j + 3] = _mm256_permute2x128_si256(vec[8 + j], vec[12 + j], 0b00110001);
-        }
-        /* interleave the 32 bit words across the two 128 bit lanes */
-        /* [7777-6666 5555-4444 | 3333-2222 1111-0000] -> [7777-6666 3333-2222 | 5555-4444
-         * 1111-0000] */
-        for (size_t j = 0; j < 16; ++j) {
-            tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
-        }
-        /* now we have [DCDC BABA] [DCDC BABA] [HGHG FEFE] [HGHG FEFE] ... */
-        for (size_t j = 0; j < 8; ++j) {
-            vec[2 * j + 0] = _mm256_permute2x128_si256(tmp[2 * j], tmp[2 * j + 1], 0b00100000);
-            vec[2 * j + 1] = _mm256_permute2x128_si256(tmp[2 * j], tmp[2 * j + 1], 0b00110001);
-        }
-        /* now we have [BABA BABA] [DCDC DCDC] [FEFE FEFE] [HGHG HGHG] ... */
-        /* deinterleave the 32 bit words across the two 128 bit lanes */
-        /* [7777 6666 5555 4444 | 3333 2222 1111 0000] -> [7777 5555 3333 1111 | 6666 4444 2222
-         * 0000] */
-        const __m256i permute_mask =
-            _mm256_set_epi32(0x07, 0x05, 0x03, 0x01, 0x06, 0x04, 0x02, 0x00);
-        for (size_t j = 0; j < 16; ++j) {
-            vec[j] = _mm256_permutevar8x32_epi32(vec[j], permute_mask);
-        }
-
-        /* store 4 words into each row */
-        for (size_t j = 0; j < 16; ++j) {
-            memcpy(dst[2 * j] + 16 * superblock_i, (uint8_t*)(&vec[j]), 16);
-            memcpy(dst[2 * j + 1] + 16 * superblock_i, (uint8_t*)(&vec[j]) + 16, 16);
-        }
+        transpose_bit_Nx32_superblock(dst, 16 * superblock_i, src + 4 * superblock_i * 32, 4);
     }
-    /* process the remaining 16x16 blocks */
-    const uint32_t* rest_src = src + 4 * num_super_blocks * 32;
-    uint8_t* rest_dst[32];
-    for (size_t i = 0; i < 32; ++i) {
-        rest_dst[i] = dst[i] + 4 * 4 * num_super_blocks;
+    if (num_rest == 1) {
+        const uint32_t* rest_src = src + 4 * num_super_blocks * 32;
+        uint8_t* rest_dst[32];
+        for (size_t i = 0; i < 32; ++i) {
+            rest_dst[i] = dst[i] + 4 * 4 * num_super_blocks;
+        }
+        transpose_bit_Nx32_onebyone(rest_dst, rest_src, num_rest);
+    } else if (num_rest != 0) {
+        transpose_bit_Nx32_superblock(dst, 16 * num_super_blocks, src + 4 * num_super_blocks * 32,
+                                      num_rest);
     }
-    transpose_bit_Nx32_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_64xN_onebyone(uint64_t* dst, const uint8_t* const* src, size_t N) {
+static void transpose_bit_64xN_onebyone(uint64_t* dst, const uint8_t* const* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 64xN matrix: */
@@ -473,7 +775,7 @@ void transpose_bit_64xN_onebyone(uint64_t* dst, const uint8_t* const* src, size_
     }
 }
 
-void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
+static void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 64xN matrix: */
@@ -481,8 +783,7 @@ void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
     for (size_t block_i = 0; block_i < N; ++block_i) {
         /* transpose 64x64 blocks */
         __m256i vec[16];
-        memcpy(vec, src + block_i * 64, 512);
-        transpose_bit_64x64_inplace_aligned(vec);
+        transpose_bit_64x64(vec, src + block_i * 64);
         /* store a word into each row */
         for (size_t i = 0; i < 64; ++i) {
             memcpy(dst[i] + 8 * block_i, (uint8_t*)(&vec) + 8 * i, 8);
@@ -490,47 +791,75 @@ void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
     }
 }
 
-void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
+/* Loads the rows of a 64xN super block of 4 blocks into vec[0..63]. */
+static inline void transpose_bit_64xN_load(__m256i* vec, const uint8_t* const* src, size_t offset,
+                                           size_t N) {
+    prefetch_rows(src, 64, offset, 32, 8 * N);
+    /* load 4 words from each row */
+    /* -> [AAAA] [BBBB] [CCCC] [DDDD] ... */
+    for (size_t j = 0; j < 64; ++j) {
+        vec[j] = _mm256_loadu_si256((const __m256i*)(src[j] + offset));
+    }
+}
+
+/* Transposes the 64xN super block loaded into vec[0..63] and stores it. */
+static inline void transpose_bit_64xN_store(uint64_t* dst, __m256i* vec, const int stream) {
+    /* transpose 4 64x64 blocks */
+    __m256i tmp[64];
+    /* interleave 128 bit words */
+    /* -> [BBAA] [BBAA] [DDCC] [DDCC] ... */
+    for (size_t j = 0; j < 32; ++j) {
+        tmp[2 * j + 0] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00100000);
+        tmp[2 * j + 1] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00110001);
+    }
+    /* swap the middle 64 bit words */
+    /* -> [BABA] [BABA] [DCDC] [DCDC] ... */
+    for (size_t j = 0; j < 64; ++j) {
+        tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
+    }
+    /* interleave 128 bit words again and put the results to the correct position */
+    /* -> [DCBA] [HGFE] ... [DCBA] [HGFE] ... [DCBA] [HGFE] ... [DCBA] [HGFE] ... */
+    for (size_t j = 0; j < 16; ++j) {
+        vec[0 + j] = _mm256_permute2x128_si256(tmp[4 * j + 0], tmp[4 * j + 2], 0b00100000);
+        vec[16 + j] = _mm256_permute2x128_si256(tmp[4 * j + 0], tmp[4 * j + 2], 0b00110001);
+        vec[32 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00100000);
+        vec[48 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00110001);
+    }
+    /* transpose each 64x64 block */
+    for (size_t j = 0; j < 4; ++j) {
+        transpose_bit_64x64_inplace_aligned(&vec[16 * j]);
+    }
+    __m256i* dst_p = (__m256i*)(dst);
+    for (size_t j = 0; j < 64; ++j) {
+        if (stream) {
+            _mm256_stream_si256(&dst_p[j], vec[j]);
+        } else {
+            _mm256_storeu_si256(&dst_p[j], vec[j]);
+        }
+    }
+}
+
+static inline void transpose_bit_64xN_impl(uint64_t* dst, const uint8_t* const* src, size_t N,
+                                           const int stream) {
     /* batched implementation */
 
     /* transposition of a 64xN matrix: */
     /* - partition the matrix into blocks of size 64x64 */
-    /* - process as many as possible in super blocks of 4 */
+    /* - process as many as possible in super blocks of 4, loading the rows of the next super
+     *   block before the current one is transposed */
     size_t num_super_blocks = N / 4;
     size_t num_rest = N % 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        /* transpose 4 64x64 blocks */
-        __m256i vec[64];
-        __m256i tmp[64];
-        /* load 4 words from each row */
-        /* -> [AAAA] [BBBB] [CCCC] [DDDD] ... */
-        for (size_t j = 0; j < 64; ++j) {
-            memcpy((uint8_t*)(&vec[j]), src[j] + 32 * superblock_i, 32);
-        }
-        /* interleave 128 bit words */
-        /* -> [BBAA] [BBAA] [DDCC] [DDCC] ... */
-        for (size_t j = 0; j < 32; ++j) {
-            tmp[2 * j + 0] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00100000);
-            tmp[2 * j + 1] = _mm256_permute2x128_si256(vec[2 * j], vec[2 * j + 1], 0b00110001);
-        }
-        /* swap the middle 64 bit words */
-        /* -> [BABA] [BABA] [DCDC] [DCDC] ... */
-        for (size_t j = 0; j < 64; ++j) {
-            tmp[j] = _mm256_permute4x64_epi64(tmp[j], 0b11011000);
-        }
-        /* interleave 128 bit words again and put the results to the correct position */
-        /* -> [DCBA] [HGFE] ... [DCBA] [HGFE] ... [DCBA] [HGFE] ... [DCBA] [HGFE] ... */
-        for (size_t j = 0; j < 16; ++j) {
-            vec[0 + j] = _mm256_permute2x128_si256(tmp[4 * j + 0], tmp[4 * j + 2], 0b00100000);
-            vec[16 + j] = _mm256_permute2x128_si256(tmp[4 * j + 0], tmp[4 * j + 2], 0b00110001);
-            vec[32 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00100000);
-            vec[48 + j] = _mm256_permute2x128_si256(tmp[4 * j + 1], tmp[4 * j + 3], 0b00110001);
-        }
-        /* transpose each 64x64 block */
-        for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_64x64_inplace_aligned(&vec[16 * j]);
+    if (num_super_blocks > 0) {
+        __m256i vec[2][64];
+        transpose_bit_64xN_load(vec[0], src, 0, N);
+        for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+            __m256i* current = vec[superblock_i % 2];
+            if (superblock_i + 1 < num_super_blocks) {
+                transpose_bit_64xN_load(vec[(superblock_i + 1) % 2], src, 32 * (superblock_i + 1),
+                                        N);
+            }
+            transpose_bit_64xN_store(&dst[256 * superblock_i], current, stream);
         }
-        memcpy(&dst[256 * superblock_i], vec, 64 * 32);
     }
     /* process the remaining 64x64 blocks */
     uint64_t* rest_dst = dst + 4 * num_super_blocks * 64;
@@ -539,6 +868,25 @@ void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
         rest_src[i] = src[i] + 4 * 8 * num_super_blocks;
     }
     transpose_bit_64xN_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(512 * N)) {
+        transpose_bit_64xN_nt(dst, src, N);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 32)) {
+        transpose_bit_64xN_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0);
+    }
 }
 
 void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
@@ -553,11 +901,9 @@ void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
         /* transpose 4 64x64 blocks */
         __m256i vec[64];
         __m256i tmp[64];
-        /* load four 64x64 matrices */
-        memcpy(vec, &src[256 * superblock_i], 64 * 32);
-        // transpose each 64x64 block
+        /* load four 64x64 matrices and transpose each of them */
         for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_64x64_inplace_aligned(&vec[16 * j]);
+            transpose_bit_64x64(&vec[16 * j], &src[256 * superblock_i + 64 * j]);
         }
         // deinterleave 128 bit words again and put the results to the correct position
         // -> [BABA] [BABA] [DCDC] [DCDC] ...
@@ -592,57 +938,41 @@ void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
     transpose_bit_Nx64_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_128xN_onebyone(uint8_t* dst, const uint8_t* const* src, size_t N) {
-    /* one-by-one implementation */
-
+static inline void transpose_bit_128xN_impl(uint8_t* dst, const uint8_t* const* src, size_t N,
+                                            const int stream) {
     /* transposition of a 128xN matrix: */
     /* - partition the matrix into blocks of size 128x128 */
+    /* - load the rows of each block directly and write the transposed block once */
     for (size_t block_i = 0; block_i < N; ++block_i) {
-        /* transpose 128x128 blocks */
-        /* copy a word from each row */
-        for (size_t j = 0; j < 128; ++j) {
-            memcpy(dst + 2048 * block_i + 16 * j, src[j] + 16 * block_i, 16);
+        prefetch_rows(src, 128, 16 * block_i, 16, 16 * N);
+        if (stream) {
+            transpose_bit_128x128_gather_stream(dst + 2048 * block_i, src, 16 * block_i);
+        } else {
+            transpose_bit_128x128_gather(dst + 2048 * block_i, src, 16 * block_i);
         }
-        transpose_bit_128x128_inplace(&dst[2048 * block_i]);
+    }
+    if (stream) {
+        _mm_sfence();
     }
 }
 
 void transpose_bit_128xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
-    /* batched implementation */
-
-    /* transposition of a 128xN matrix: */
-    /* - partition the matrix into blocks of size 128x128 */
-    /* - process as many as possible in super blocks of 4 */
-    size_t num_super_blocks = N / 4;
-    size_t num_rest = N % 4;
-    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        __m256i vec[256];
-        /* transpose 128x128 blocks */
-        /* copy four words from each row */
-        for (size_t j = 0; j < 128; ++j) {
-            memcpy((uint8_t*)(&vec[2 * j]), src[j] + 64 * superblock_i, 64);
-        }
-        const __m128i* vec_as_128i_p = (const __m128i*)(vec);
-        for (size_t j = 0; j < 128; ++j) {
-            for (size_t k = 0; k < 4; ++k) {
-                memcpy(&dst[8192 * superblock_i + 2048 * k + 16 * j], &vec_as_128i_p[4 * j + k],
-                       16);
-            }
-        }
-        for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_128x128_inplace(&dst[8192 * superblock_i + 2048 * j]);
-        }
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_128xN_nt(dst, src, N);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0);
     }
-    /* process the remaining 128x128 blocks */
-    uint8_t* rest_dst = dst + 4 * num_super_blocks * 128 * 16;
-    const uint8_t* rest_src[128];
-    for (size_t i = 0; i < 128; ++i) {
-        rest_src[i] = src[i] + 4 * 16 * num_super_blocks;
+}
+
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 32)) {
+        transpose_bit_128xN_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0);
     }
-    transpose_bit_128xN_onebyone(rest_dst, rest_src, num_rest);
 }
 
-void transpose_bit_Nx128_onebyone(uint8_t** dst, const uint8_t* src, size_t N) {
+static void transpose_bit_Nx128_onebyone(uint8_t** dst, const uint8_t* src, size_t N) {
     /* one-by-one implementation */
 
     /* transposition of a 128xN matrix: */
@@ -650,8 +980,7 @@ void transpose_bit_Nx128_onebyone(uint8_t** dst, const uint8_t* src, size_t N) {
     for (size_t block_i = 0; block_i < N; ++block_i) {
         /* transpose 128x128 blocks */
         __m256i vec[64];
-        memcpy(vec, src + block_i * 2048, 2048);
-        transpose_bit_128x128_inplace_aligned(vec);
+        transpose_bit_128x128(vec, src + block_i * 2048);
         /* store a word into each row */
         for (size_t i = 0; i < 128; ++i) {
             memcpy(dst[i] + 16 * block_i, (uint8_t*)(&vec) + 16 * i, 16);
@@ -659,40 +988,112 @@ void transpose_bit_Nx128_onebyone(uint8_t** dst, const uint8_t* src, size_t N) {
     }
 }
 
-void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
+static inline void transpose_bit_Nx128_impl(uint8_t** dst, const uint8_t* src, size_t N,
+                                            const int stream) {
     /* batched implementation */
 
     /* transposition of a Nx128 matrix: */
     /* - partition the matrix into blocks of size 128x128 */
-    /* - process as many as possible in super blocks of 4 */
-    size_t num_super_blocks = N / 4;
-    size_t num_rest = N % 4;
+    /* - process as many as possible in super blocks of NX128_SUPER_BLOCK_SIZE */
+    const size_t width = NX128_SUPER_BLOCK_SIZE;
+    size_t num_super_blocks = N / width;
+    size_t num_rest = N % width;
     for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
-        __m256i vec[256];
-        __m256i tmp[256];
-        /* load four matrices */
-        memcpy(vec, &src[32 * superblock_i * 256], 256 * 32);
-        /* transpose 128x128 blocks */
-        for (size_t j = 0; j < 4; ++j) {
-            transpose_bit_128x128_inplace_aligned(&vec[64 * j]);
+        __m256i vec[64 * NX128_SUPER_BLOCK_SIZE];
+        __m256i tmp[64 * NX128_SUPER_BLOCK_SIZE];
+        /* load the 128x128 blocks and transpose them */
+        for (size_t j = 0; j < width; ++j) {
+            transpose_bit_128x128(&vec[64 * j], &src[2048 * (width * superblock_i + j)]);
         }
         const __m128i* vec_as_128i_p = (const __m128i*)(vec);
         __m128i* tmp_as_128i_p = (__m128i*)(tmp);
         for (size_t j = 0; j < 128; ++j) {
-            for (size_t k = 0; k < 4; ++k) {
-                tmp_as_128i_p[4 * j + k] = vec_as_128i_p[128 * k + j];
+            for (size_t k = 0; k < width; ++k) {
+                tmp_as_128i_p[width * j + k] = vec_as_128i_p[128 * k + j];
             }
         }
-        /* copy four words to each row */
+        /* copy width words to each row */
         for (size_t j = 0; j < 128; ++j) {
-            memcpy(dst[j] + 64 * superblock_i, (uint8_t*)(&tmp[2 * j]), 64);
+            uint8_t* row = dst[j] + 16 * width * superblock_i;
+            if (stream && width % 2 == 0) {
+                for (size_t k = 0; k < width / 2; ++k) {
+                    _mm256_stream_si256((__m256i*)(row) + k, tmp[width / 2 * j + k]);
+                }
+            } else if (stream) {
+                _mm_stream_si128((__m128i*)(row), tmp_as_128i_p[j]);
+            } else {
+                memcpy(row, &tmp_as_128i_p[width * j], 16 * width);
+            }
         }
     }
     /* process the remaining 128x128 blocks */
-    const uint8_t* rest_src = src + 4 * num_super_blocks * 128 * 16;
+    const uint8_t* rest_src = src + width * num_super_blocks * 128 * 16;
     uint8_t* rest_dst[128];
     for (size_t i = 0; i < 128; ++i) {
-        rest_dst[i] = dst[i] + 4 * 16 * num_super_blocks;
+        rest_dst[i] = dst[i] + width * 16 * num_super_blocks;
     }
     transpose_bit_Nx128_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_Nx128_nt(dst, src, N);
+    } else {
+        transpose_bit_Nx128_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* every row receives 16 bytes per block, written in 32 byte pieces if possible */
+    if (rows_aligned_to(dst, 128, NX128_SUPER_BLOCK_SIZE == 1 ? 16 : 32)) {
+        transpose_bit_Nx128_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_Nx128_impl(dst, src, N, 0);
+    }
+}
+
+/* the 256 bit kernels read and write the blocks with unaligned loads and stores, so the
+ * _aligned variants are the regular ones */
+
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_8xN(dst, src, N);
+}
+
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx8(dst, src, N);
+}
+
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_16xN(dst, src, N);
+}
+
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N) {
+    transpose_bit_Nx16(dst, src, N);
+}
+
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_32xN(dst, src, N);
+}
+
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N) {
+    transpose_bit_Nx32(dst, src, N);
+}
+
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nx64(dst, src, N);
+}
+
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
 }
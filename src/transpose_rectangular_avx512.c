@@ -0,0 +1,780 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_extra_avx512.h"
+#include "bit_transpose_prefetch.h"
+#include "bit_transpose_stream.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+/* Load four 128 bit words into the lanes of one register. */
+static inline __m512i loadu_4x128(const uint8_t* src_0, const uint8_t* src_1,
+                                  const uint8_t* src_2, const uint8_t* src_3) {
+    __m512i vec = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)(src_0)));
+    vec = _mm512_inserti32x4(vec, _mm_loadu_si128((const __m128i*)(src_1)), 1);
+    vec = _mm512_inserti32x4(vec, _mm_loadu_si128((const __m128i*)(src_2)), 2);
+    vec = _mm512_inserti32x4(vec, _mm_loadu_si128((const __m128i*)(src_3)), 3);
+    return vec;
+}
+
+/* Load two 256 bit words into the halves of one register. */
+static inline __m512i loadu_2x256(const uint8_t* src_0, const uint8_t* src_1) {
+    __m512i vec = _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i*)(src_0)));
+    return _mm512_inserti64x4(vec, _mm256_loadu_si256((const __m256i*)(src_1)), 1);
+}
+
+void transpose_bit_8xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    /* shuffle / permutation masks used below */
+    const __m512i shuffle_mask = _mm512_set_epi64(
+        0x0f070e060d050c04, 0x0b030a0209010800, 0x0f070e060d050c04, 0x0b030a0209010800,
+        0x0f070e060d050c04, 0x0b030a0209010800, 0x0f070e060d050c04, 0x0b030a0209010800);
+    const __m512i permute_mask =
+        _mm512_set_epi16(31, 23, 15, 7, 30, 22, 14, 6, 29, 21, 13, 5, 28, 20, 12, 4, 27, 19, 11, 3,
+                         26, 18, 10, 2, 25, 17, 9, 1, 24, 16, 8, 0);
+
+    /* transposition of a 8xN matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 8 */
+    size_t num_super_blocks = N / 8;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 8 8x8 blocks */
+        uint64_t words[8];
+        /* load 8 words from each row */
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(&words[i], src[i] + 8 * superblock_i, 8);
+        }
+        __m512i vec = _mm512_set_epi64(words[7], words[6], words[5], words[4], words[3],
+                                       words[2], words[1], words[0]);
+        /* interleave the bytes of the two rows on each 128 bit lane */
+        /* [FEDC BA98 7654 3210] -> [F7E6 D5C4 B3A2 9180] */
+        vec = _mm512_shuffle_epi8(vec, shuffle_mask);
+        /* gather the 16 bit words belonging to the same block across lanes */
+        vec = _mm512_permutexvar_epi16(permute_mask, vec);
+        /* now each 64 bit word contains a 8x8 submatrix which we transpose separately */
+        vec = transpose_bit_8x8_packed_x8_direct(vec);
+        memcpy(&dst[64 * superblock_i], &vec, 64);
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 8 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            block |= (uint64_t)(src[i][block_i]) << (i * 8);
+        }
+        block = transpose_bit_8x8_direct(block);
+        memcpy(&dst[8 * block_i], &block, 8);
+    }
+}
+
+void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* shuffle / permutation masks used below */
+    const __m512i shuffle_mask = _mm512_set_epi64(
+        0x0f0d0b0907050301, 0x0e0c0a0806040200, 0x0f0d0b0907050301, 0x0e0c0a0806040200,
+        0x0f0d0b0907050301, 0x0e0c0a0806040200, 0x0f0d0b0907050301, 0x0e0c0a0806040200);
+    const __m512i permute_mask =
+        _mm512_set_epi16(31, 27, 23, 19, 15, 11, 7, 3, 30, 26, 22, 18, 14, 10, 6, 2, 29, 25, 21,
+                         17, 13, 9, 5, 1, 28, 24, 20, 16, 12, 8, 4, 0);
+
+    /* transposition of a Nx8 matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 8 */
+    size_t num_super_blocks = N / 8;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 8 8x8 blocks */
+        /* load 8 blocks */
+        __m512i vec;
+        memcpy(&vec, &src[64 * superblock_i], 64);
+        /* each 64 bit word contains a 8x8 submatrix which we transpose separately */
+        vec = transpose_bit_8x8_packed_x8_direct(vec);
+        /* scatter the 16 bit words of each block across lanes */
+        vec = _mm512_permutexvar_epi16(permute_mask, vec);
+        /* deinterleave the bytes of the two rows on each 128 bit lane */
+        /* [FEDC BA98 7654 3210] -> [FDB9 7531 ECA8 6420] */
+        vec = _mm512_shuffle_epi8(vec, shuffle_mask);
+        /* store 8 words into each row */
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(dst[i] + 8 * superblock_i, (uint8_t*)(&vec) + 8 * i, 8);
+        }
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 8 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block;
+        memcpy(&block, &src[8 * block_i], 8);
+        block = transpose_bit_8x8_direct(block);
+        for (size_t i = 0; i < 8; ++i) {
+            dst[i][block_i] = (block >> (i * 8)) & 0xff;
+        }
+    }
+}
+
+static void transpose_bit_16xN_onebyone(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 16x16 blocks */
+        __m256i vec;
+        /* load a word from each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy((uint8_t*)(&vec) + 2 * i, src[i] + 2 * block_i, 2);
+        }
+        vec = transpose_bit_16x16_direct(vec);
+        memcpy(&dst[block_i * 16], &vec, 32);
+    }
+}
+
+void transpose_bit_16xN(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi16(
+        59, 51, 43, 35, 27, 19, 11, 3, 58, 50, 42, 34, 26, 18, 10, 2, 57, 49, 41, 33, 25, 17, 9,
+        1, 56, 48, 40, 32, 24, 16, 8, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi16(
+        63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22, 14, 6, 61, 53, 45, 37, 29, 21, 13,
+        5, 60, 52, 44, 36, 28, 20, 12, 4);
+    const __m512i permute_mask_blocks_a = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+    const __m512i permute_mask_blocks_b = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 8 */
+    size_t num_super_blocks = N / 8;
+    size_t num_rest = N % 8;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 8 16x16 blocks */
+        __m512i vec[4];
+        __m512i tmp[4];
+        /* load 8 words from each row, four rows per register */
+        for (size_t j = 0; j < 4; ++j) {
+            vec[j] = loadu_4x128(src[4 * j + 0] + 16 * superblock_i,
+                                 src[4 * j + 1] + 16 * superblock_i,
+                                 src[4 * j + 2] + 16 * superblock_i,
+                                 src[4 * j + 3] + 16 * superblock_i);
+        }
+        /* collect the words of the rows 0-7 (vec[0], vec[1]) and 8-15 (vec[2], vec[3]) */
+        /* belonging to blocks 0-3 (vec[0], vec[2]) and 4-7 (vec[1], vec[3]) */
+        permute_pair_epi16(&vec[0], &vec[1], permute_mask_rows_a, permute_mask_rows_b);
+        permute_pair_epi16(&vec[2], &vec[3], permute_mask_rows_a, permute_mask_rows_b);
+        /* combine the upper and lower halves of the blocks, two blocks per register */
+        tmp[0] = _mm512_permutex2var_epi64(vec[0], permute_mask_blocks_a, vec[2]);
+        tmp[1] = _mm512_permutex2var_epi64(vec[0], permute_mask_blocks_b, vec[2]);
+        tmp[2] = _mm512_permutex2var_epi64(vec[1], permute_mask_blocks_a, vec[3]);
+        tmp[3] = _mm512_permutex2var_epi64(vec[1], permute_mask_blocks_b, vec[3]);
+
+        for (size_t j = 0; j < 4; ++j) {
+            tmp[j] = transpose_bit_16x16_packed_x2_direct(tmp[j]);
+        }
+        memcpy(&dst[8 * superblock_i * 16], &tmp, 4 * 64);
+    }
+    /* process the remaining 16x16 blocks */
+    uint16_t* rest_dst = dst + 8 * num_super_blocks * 16;
+    const uint8_t* rest_src[16];
+    for (size_t i = 0; i < 16; ++i) {
+        rest_src[i] = src[i] + 2 * 8 * num_super_blocks;
+    }
+    transpose_bit_16xN_onebyone(rest_dst, rest_src, num_rest);
+}
+
+static void transpose_bit_Nx16_onebyone(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx16 matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 16x16 blocks */
+        __m256i vec;
+        memcpy(&vec, &src[block_i * 16], 32);
+        vec = transpose_bit_16x16_direct(vec);
+        /* store a word into each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(dst[i] + 2 * block_i, (uint8_t*)(&vec) + 2 * i, 2);
+        }
+    }
+}
+
+void transpose_bit_Nx16(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi16(
+        59, 51, 43, 35, 27, 19, 11, 3, 58, 50, 42, 34, 26, 18, 10, 2, 57, 49, 41, 33, 25, 17, 9,
+        1, 56, 48, 40, 32, 24, 16, 8, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi16(
+        63, 55, 47, 39, 31, 23, 15, 7, 62, 54, 46, 38, 30, 22, 14, 6, 61, 53, 45, 37, 29, 21, 13,
+        5, 60, 52, 44, 36, 28, 20, 12, 4);
+    const __m512i permute_mask_blocks_a = _mm512_set_epi64(13, 12, 9, 8, 5, 4, 1, 0);
+    const __m512i permute_mask_blocks_b = _mm512_set_epi64(15, 14, 11, 10, 7, 6, 3, 2);
+
+    /* transposition of a Nx16 matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 8 */
+    size_t num_super_blocks = N / 8;
+    size_t num_rest = N % 8;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 8 16x16 blocks */
+        __m512i vec[4];
+        __m512i tmp[4];
+        /* load 8 16x16 matrices and transpose them */
+        memcpy(tmp, &src[8 * superblock_i * 16], 4 * 64);
+        for (size_t j = 0; j < 4; ++j) {
+            tmp[j] = transpose_bit_16x16_packed_x2_direct(tmp[j]);
+        }
+        /* now do the reverse permutations of those in the 16xN case */
+        /* separate the upper and lower halves of the blocks */
+        vec[0] = _mm512_permutex2var_epi64(tmp[0], permute_mask_blocks_a, tmp[1]);
+        vec[2] = _mm512_permutex2var_epi64(tmp[0], permute_mask_blocks_b, tmp[1]);
+        vec[1] = _mm512_permutex2var_epi64(tmp[2], permute_mask_blocks_a, tmp[3]);
+        vec[3] = _mm512_permutex2var_epi64(tmp[2], permute_mask_blocks_b, tmp[3]);
+        /* distribute the words to the rows */
+        permute_pair_epi16(&vec[0], &vec[1], permute_mask_rows_a, permute_mask_rows_b);
+        permute_pair_epi16(&vec[2], &vec[3], permute_mask_rows_a, permute_mask_rows_b);
+        /* store 8 words into each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(dst[i] + 16 * superblock_i, (uint8_t*)(&vec[i / 4]) + 16 * (i % 4), 16);
+        }
+    }
+    /* process the remaining 16x16 blocks */
+    const uint16_t* rest_src = src + 8 * num_super_blocks * 16;
+    uint8_t* rest_dst[16];
+    for (size_t i = 0; i < 16; ++i) {
+        rest_dst[i] = dst[i] + 2 * 8 * num_super_blocks;
+    }
+    transpose_bit_Nx16_onebyone(rest_dst, rest_src, num_rest);
+}
+
+static void transpose_bit_32xN_onebyone(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 32xN matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 32x32 blocks */
+        __m512i vec[2];
+        /* load a word from each row */
+        for (size_t j = 0; j < 32; ++j) {
+            memcpy((uint8_t*)(vec) + 4 * j, src[j] + 4 * block_i, 4);
+        }
+        transpose_bit_32x32_zmm(vec);
+        memcpy(&dst[32 * block_i], vec, 128);
+    }
+}
+
+void transpose_bit_32xN(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi32(29, 25, 21, 17, 13, 9, 5, 1, 28, 24, 20,
+                                                         16, 12, 8, 4, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi32(31, 27, 23, 19, 15, 11, 7, 3, 30, 26, 22,
+                                                         18, 14, 10, 6, 2);
+
+    /* transposition of a 32xN matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 32x32 blocks */
+        __m512i vec[8];
+        __m512i tmp[8];
+        /* load 4 words from each row, four rows per register */
+        for (size_t j = 0; j < 8; ++j) {
+            vec[j] = loadu_4x128(src[4 * j + 0] + 16 * superblock_i,
+                                 src[4 * j + 1] + 16 * superblock_i,
+                                 src[4 * j + 2] + 16 * superblock_i,
+                                 src[4 * j + 3] + 16 * superblock_i);
+        }
+        /* collect the words of rows 8m to 8m+7 (vec[2m], vec[2m+1]) */
+        /* belonging to blocks 0, 1 (vec[2m]) and 2, 3 (vec[2m+1]) */
+        for (size_t m = 0; m < 4; ++m) {
+            permute_pair_epi32(&vec[2 * m], &vec[2 * m + 1], permute_mask_rows_a,
+                               permute_mask_rows_b);
+        }
+        /* combine them such that tmp[2b] and tmp[2b+1] contain rows 0-15 and 16-31 of block b */
+        for (size_t h = 0; h < 2; ++h) {
+            tmp[0 + h] = _mm512_shuffle_i64x2(vec[4 * h], vec[4 * h + 2], 0b01000100);
+            tmp[2 + h] = _mm512_shuffle_i64x2(vec[4 * h], vec[4 * h + 2], 0b11101110);
+            tmp[4 + h] = _mm512_shuffle_i64x2(vec[4 * h + 1], vec[4 * h + 3], 0b01000100);
+            tmp[6 + h] = _mm512_shuffle_i64x2(vec[4 * h + 1], vec[4 * h + 3], 0b11101110);
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            transpose_bit_32x32_zmm(&tmp[2 * j]);
+        }
+        memcpy(&dst[128 * superblock_i], &tmp, 8 * 64);
+    }
+    /* process the remaining 32x32 blocks */
+    uint32_t* rest_dst = dst + 4 * num_super_blocks * 32;
+    const uint8_t* rest_src[32];
+    for (size_t i = 0; i < 32; ++i) {
+        rest_src[i] = src[i] + 4 * 4 * num_super_blocks;
+    }
+    transpose_bit_32xN_onebyone(rest_dst, rest_src, num_rest);
+}
+
+static void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 32x32 blocks */
+        __m512i vec[2];
+        memcpy(vec, src + block_i * 32, 128);
+        transpose_bit_32x32_zmm(vec);
+        /* store a word into each row */
+        for (size_t j = 0; j < 32; ++j) {
+            memcpy(dst[j] + 4 * block_i, (uint8_t*)(vec) + 4 * j, 4);
+        }
+    }
+}
+
+void transpose_bit_Nx32(uint8_t** dst, const uint32_t* src, size_t N) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi32(27, 19, 11, 3, 26, 18, 10, 2, 25, 17, 9,
+                                                         1, 24, 16, 8, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi32(31, 23, 15, 7, 30, 22, 14, 6, 29, 21, 13,
+                                                         5, 28, 20, 12, 4);
+
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 32x32 blocks */
+        __m512i vec[8];
+        __m512i tmp[8];
+        /* load four 32x32 matrices and transpose them */
+        memcpy(tmp, &src[128 * superblock_i], 8 * 64);
+        for (size_t j = 0; j < 4; ++j) {
+            transpose_bit_32x32_zmm(&tmp[2 * j]);
+        }
+        /* now do the reverse permutations of those in the 32xN case */
+        for (size_t h = 0; h < 2; ++h) {
+            vec[4 * h + 0] = _mm512_shuffle_i64x2(tmp[0 + h], tmp[2 + h], 0b01000100);
+            vec[4 * h + 2] = _mm512_shuffle_i64x2(tmp[0 + h], tmp[2 + h], 0b11101110);
+            vec[4 * h + 1] = _mm512_shuffle_i64x2(tmp[4 + h], tmp[6 + h], 0b01000100);
+            vec[4 * h + 3] = _mm512_shuffle_i64x2(tmp[4 + h], tmp[6 + h], 0b11101110);
+        }
+        for (size_t m = 0; m < 4; ++m) {
+            permute_pair_epi32(&vec[2 * m], &vec[2 * m + 1], permute_mask_rows_a,
+                               permute_mask_rows_b);
+        }
+        /* store 4 words into each row */
+        for (size_t i = 0; i < 32; ++i) {
+            memcpy(dst[i] + 16 * superblock_i, (uint8_t*)(&vec[i / 4]) + 16 * (i % 4), 16);
+        }
+    }
+    /* process the remaining 32x32 blocks */
+    const uint32_t* rest_src = src + 4 * num_super_blocks * 32;
+    uint8_t* rest_dst[32];
+    for (size_t i = 0; i < 32; ++i) {
+        rest_dst[i] = dst[i] + 4 * 4 * num_super_blocks;
+    }
+    transpose_bit_Nx32_onebyone(rest_dst, rest_src, num_rest);
+}
+
+static void transpose_bit_64xN_onebyone(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 64xN matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 64x64 blocks */
+        __m512i vec[8];
+        /* load a word from each row */
+        for (size_t j = 0; j < 64; ++j) {
+            memcpy((uint8_t*)(vec) + 8 * j, src[j] + 8 * block_i, 8);
+        }
+        transpose_bit_64x64_zmm(vec);
+        memcpy(&dst[64 * block_i], vec, 512);
+    }
+}
+
+static void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx64 matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 64x64 blocks */
+        __m512i vec[8];
+        memcpy(vec, src + block_i * 64, 512);
+        transpose_bit_64x64_zmm(vec);
+        /* store a word into each row */
+        for (size_t i = 0; i < 64; ++i) {
+            memcpy(dst[i] + 8 * block_i, (uint8_t*)(vec) + 8 * i, 8);
+        }
+    }
+}
+
+static inline void transpose_bit_64xN_impl(uint64_t* dst, const uint8_t* const* src, size_t N,
+                                           const int stream) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi64(13, 9, 5, 1, 12, 8, 4, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi64(15, 11, 7, 3, 14, 10, 6, 2);
+
+    /* transposition of a 64xN matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 64x64 blocks */
+        __m512i vec[32];
+        __m512i tmp[32];
+        prefetch_rows(src, 64, 32 * superblock_i, 32, 8 * N);
+        /* load 4 words from each row, two rows per register */
+        for (size_t j = 0; j < 32; ++j) {
+            vec[j] = loadu_2x256(src[2 * j + 0] + 32 * superblock_i,
+                                 src[2 * j + 1] + 32 * superblock_i);
+        }
+        /* collect the words of rows 4s to 4s+3 (vec[2s], vec[2s+1]) */
+        /* belonging to blocks 0, 1 (vec[2s]) and 2, 3 (vec[2s+1]) */
+        for (size_t j = 0; j < 32; j += 2) {
+            permute_pair_epi64(&vec[j], &vec[j + 1], permute_mask_rows_a, permute_mask_rows_b);
+        }
+        /* combine them such that tmp[8b + h] contains rows 8h to 8h+7 of block b */
+        for (size_t h = 0; h < 8; ++h) {
+            tmp[0 + h] = _mm512_shuffle_i64x2(vec[4 * h], vec[4 * h + 2], 0b01000100);
+            tmp[8 + h] = _mm512_shuffle_i64x2(vec[4 * h], vec[4 * h + 2], 0b11101110);
+            tmp[16 + h] = _mm512_shuffle_i64x2(vec[4 * h + 1], vec[4 * h + 3], 0b01000100);
+            tmp[24 + h] = _mm512_shuffle_i64x2(vec[4 * h + 1], vec[4 * h + 3], 0b11101110);
+        }
+        /* transpose each 64x64 block */
+        for (size_t j = 0; j < 4; ++j) {
+            transpose_bit_64x64_zmm(&tmp[8 * j]);
+        }
+        if (stream) {
+            __m512i* dst_p = (__m512i*)(&dst[256 * superblock_i]);
+            for (size_t j = 0; j < 32; ++j) {
+                _mm512_stream_si512(&dst_p[j], tmp[j]);
+            }
+        } else {
+            memcpy(&dst[256 * superblock_i], tmp, 32 * 64);
+        }
+    }
+    /* process the remaining 64x64 blocks */
+    uint64_t* rest_dst = dst + 4 * num_super_blocks * 64;
+    const uint8_t* rest_src[64];
+    for (size_t i = 0; i < 64; ++i) {
+        rest_src[i] = src[i] + 4 * 8 * num_super_blocks;
+    }
+    transpose_bit_64xN_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(512 * N)) {
+        transpose_bit_64xN_nt(dst, src, N);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 64)) {
+        transpose_bit_64xN_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
+    /* batched implementation */
+
+    /* permutation masks used below */
+    const __m512i permute_mask_rows_a = _mm512_set_epi64(13, 9, 5, 1, 12, 8, 4, 0);
+    const __m512i permute_mask_rows_b = _mm512_set_epi64(15, 11, 7, 3, 14, 10, 6, 2);
+
+    /* transposition of a Nx64 matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 64x64 blocks */
+        __m512i vec[32];
+        __m512i tmp[32];
+        /* load four 64x64 matrices */
+        memcpy(tmp, &src[256 * superblock_i], 32 * 64);
+        /* transpose each 64x64 block */
+        for (size_t j = 0; j < 4; ++j) {
+            transpose_bit_64x64_zmm(&tmp[8 * j]);
+        }
+        /* now do the reverse permutations of those in the 64xN case */
+        for (size_t h = 0; h < 8; ++h) {
+            vec[4 * h + 0] = _mm512_shuffle_i64x2(tmp[0 + h], tmp[8 + h], 0b01000100);
+            vec[4 * h + 2] = _mm512_shuffle_i64x2(tmp[0 + h], tmp[8 + h], 0b11101110);
+            vec[4 * h + 1] = _mm512_shuffle_i64x2(tmp[16 + h], tmp[24 + h], 0b01000100);
+            vec[4 * h + 3] = _mm512_shuffle_i64x2(tmp[16 + h], tmp[24 + h], 0b11101110);
+        }
+        for (size_t j = 0; j < 32; j += 2) {
+            permute_pair_epi64(&vec[j], &vec[j + 1], permute_mask_rows_a, permute_mask_rows_b);
+        }
+        /* store 4 words into each row */
+        for (size_t i = 0; i < 64; ++i) {
+            memcpy(dst[i] + 32 * superblock_i, (uint8_t*)(&vec[i / 2]) + 32 * (i % 2), 32);
+        }
+    }
+    /* process the remaining 64x64 blocks */
+    const uint64_t* rest_src = src + 4 * num_super_blocks * 64;
+    uint8_t* rest_dst[64];
+    for (size_t i = 0; i < 64; ++i) {
+        rest_dst[i] = dst[i] + 4 * 8 * num_super_blocks;
+    }
+    transpose_bit_Nx64_onebyone(rest_dst, rest_src, num_rest);
+}
+
+/* Transpose the 4x4 matrix of 128 bit lanes given by four registers. */
+static inline void transpose_lanes_4x4(__m512i* vec) {
+    __m512i tmp[4];
+    /* [A3 A2 A1 A0], [B3 B2 B1 B0] -> [B1 B0 A1 A0], [B3 B2 A3 A2] */
+    tmp[0] = _mm512_shuffle_i64x2(vec[0], vec[1], 0b01000100);
+    tmp[1] = _mm512_shuffle_i64x2(vec[0], vec[1], 0b11101110);
+    tmp[2] = _mm512_shuffle_i64x2(vec[2], vec[3], 0b01000100);
+    tmp[3] = _mm512_shuffle_i64x2(vec[2], vec[3], 0b11101110);
+    /* [B1 B0 A1 A0], [D1 D0 C1 C0] -> [D0 C0 B0 A0], [D1 C1 B1 A1] */
+    vec[0] = _mm512_shuffle_i64x2(tmp[0], tmp[2], 0b10001000);
+    vec[1] = _mm512_shuffle_i64x2(tmp[0], tmp[2], 0b11011101);
+    vec[2] = _mm512_shuffle_i64x2(tmp[1], tmp[3], 0b10001000);
+    vec[3] = _mm512_shuffle_i64x2(tmp[1], tmp[3], 0b11011101);
+}
+
+static void transpose_bit_128xN_onebyone(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 128xN matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 128x128 blocks */
+        __m512i vec[32];
+        /* load a word from each row */
+        for (size_t j = 0; j < 128; ++j) {
+            memcpy((uint8_t*)(vec) + 16 * j, src[j] + 16 * block_i, 16);
+        }
+        transpose_bit_128x128_zmm(vec);
+        memcpy(dst + 2048 * block_i, vec, 2048);
+    }
+}
+
+static inline void transpose_bit_128xN_impl(uint8_t* dst, const uint8_t* const* src, size_t N,
+                                            const int stream) {
+    /* batched implementation */
+
+    /* transposition of a 128xN matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* vec[b] contains the 128x128 block b */
+        __m512i vec[4][32];
+        prefetch_rows(src, 128, 64 * superblock_i, 64, 16 * N);
+        for (size_t j = 0; j < 32; ++j) {
+            /* load four words from each of four rows */
+            __m512i rows[4];
+            for (size_t i = 0; i < 4; ++i) {
+                rows[i] = _mm512_loadu_si512(src[4 * j + i] + 64 * superblock_i);
+            }
+            /* and distribute them to the blocks */
+            transpose_lanes_4x4(rows);
+            for (size_t b = 0; b < 4; ++b) {
+                vec[b][j] = rows[b];
+            }
+        }
+        /* transpose 128x128 blocks */
+        for (size_t b = 0; b < 4; ++b) {
+            transpose_bit_128x128_zmm(vec[b]);
+        }
+        if (stream) {
+            __m512i* dst_p = (__m512i*)(&dst[8192 * superblock_i]);
+            for (size_t b = 0; b < 4; ++b) {
+                for (size_t j = 0; j < 32; ++j) {
+                    _mm512_stream_si512(&dst_p[32 * b + j], vec[b][j]);
+                }
+            }
+        } else {
+            memcpy(&dst[8192 * superblock_i], vec, 4 * 2048);
+        }
+    }
+    /* process the remaining 128x128 blocks */
+    uint8_t* rest_dst = dst + 4 * num_super_blocks * 128 * 16;
+    const uint8_t* rest_src[128];
+    for (size_t i = 0; i < 128; ++i) {
+        rest_src[i] = src[i] + 4 * 16 * num_super_blocks;
+    }
+    transpose_bit_128xN_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_128xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_128xN_nt(dst, src, N);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 64)) {
+        transpose_bit_128xN_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0);
+    }
+}
+
+static void transpose_bit_Nx128_onebyone(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx128 matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 128x128 blocks */
+        __m512i vec[32];
+        memcpy(vec, src + block_i * 2048, 2048);
+        transpose_bit_128x128_zmm(vec);
+        /* store a word into each row */
+        for (size_t i = 0; i < 128; ++i) {
+            memcpy(dst[i] + 16 * block_i, (uint8_t*)(vec) + 16 * i, 16);
+        }
+    }
+}
+
+static inline void transpose_bit_Nx128_impl(uint8_t** dst, const uint8_t* src, size_t N,
+                                            const int stream) {
+    /* batched implementation */
+
+    /* transposition of a Nx128 matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* load four matrices */
+        __m512i vec[4][32];
+        memcpy(vec, &src[8192 * superblock_i], 4 * 2048);
+        /* transpose 128x128 blocks */
+        for (size_t b = 0; b < 4; ++b) {
+            transpose_bit_128x128_zmm(vec[b]);
+        }
+        for (size_t j = 0; j < 32; ++j) {
+            /* collect four words for each of four rows */
+            __m512i rows[4];
+            for (size_t b = 0; b < 4; ++b) {
+                rows[b] = vec[b][j];
+            }
+            transpose_lanes_4x4(rows);
+            /* and store them */
+            for (size_t i = 0; i < 4; ++i) {
+                if (stream) {
+                    _mm512_stream_si512((__m512i*)(dst[4 * j + i] + 64 * superblock_i), rows[i]);
+                } else {
+                    _mm512_storeu_si512(dst[4 * j + i] + 64 * superblock_i, rows[i]);
+                }
+            }
+        }
+    }
+    /* process the remaining 128x128 blocks */
+    const uint8_t* rest_src = src + 4 * num_super_blocks * 128 * 16;
+    uint8_t* rest_dst[128];
+    for (size_t i = 0; i < 128; ++i) {
+        rest_dst[i] = dst[i] + 4 * 16 * num_super_blocks;
+    }
+    transpose_bit_Nx128_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_Nx128_nt(dst, src, N);
+    } else {
+        transpose_bit_Nx128_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* every row receives 64 bytes per super block */
+    if (rows_aligned_to(dst, 128, 64)) {
+        transpose_bit_Nx128_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_Nx128_impl(dst, src, N, 0);
+    }
+}
+
+/* the 512 bit kernels would need 64 byte alignment, but only 32 bytes are
+ * guaranteed, so the _aligned variants are the regular ones */
+
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_8xN(dst, src, N);
+}
+
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx8(dst, src, N);
+}
+
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_16xN(dst, src, N);
+}
+
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N) {
+    transpose_bit_Nx16(dst, src, N);
+}
+
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_32xN(dst, src, N);
+}
+
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N) {
+    transpose_bit_Nx32(dst, src, N);
+}
+
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nx64(dst, src, N);
+}
+
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
+}
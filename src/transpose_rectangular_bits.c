@@ -0,0 +1,239 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose.h"
+#include "bit_transpose_generic.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Rectangular transpositions with a number of columns (or rows) which is not
+ * necessarily a multiple of k.  The full kxk blocks are transposed by the kxN
+ * and Nxk functions of the backend, and the partial final block is padded with
+ * zeros to a square matrix.  They do not depend on the backend and are compiled
+ * once. */
+
+static void transpose_bit_kxN_bits(size_t k, uint8_t* dst, const uint8_t* const* src,
+                                   size_t num_cols) {
+    const size_t N = num_cols / k;
+    const size_t num_rest = num_cols % k;
+    transpose_bit_kxN_rows(k, dst, src, N);
+    if (num_rest == 0) {
+        return;
+    }
+    /* read only the bytes of the rows containing valid columns */
+    const size_t row_size = k / 8;
+    uint64_t block_words[256] = {0};
+    uint8_t* block = (uint8_t*)(block_words);
+    for (size_t i = 0; i < k; ++i) {
+        memcpy(block + i * row_size, src[i] + N * row_size, (num_rest + 7) / 8);
+    }
+    /* the bits following the last column end up in rows which are dropped */
+    transpose_bit_kxk_inplace(k, block);
+    memcpy(dst + N * k * row_size, block, num_rest * row_size);
+}
+
+static void transpose_bit_Nxk_bits(size_t k, uint8_t** dst, const uint8_t* src,
+                                   size_t num_rows) {
+    const size_t N = num_rows / k;
+    const size_t num_rest = num_rows % k;
+    transpose_bit_Nxk_rows(k, dst, src, N);
+    if (num_rest == 0) {
+        return;
+    }
+    const size_t row_size = k / 8;
+    uint64_t block_words[256] = {0};
+    uint8_t* block = (uint8_t*)(block_words);
+    memcpy(block, src + N * k * row_size, num_rest * row_size);
+    transpose_bit_kxk_inplace(k, block);
+    /* write the valid bits of each row, and keep the remaining bits of the last
+     * byte */
+    const size_t num_bytes = num_rest / 8;
+    const uint8_t mask = (uint8_t)((1u << (num_rest % 8)) - 1);
+    for (size_t i = 0; i < k; ++i) {
+        uint8_t* row = dst[i] + N * row_size;
+        memcpy(row, block + i * row_size, num_bytes);
+        if (mask != 0) {
+            const uint8_t bits = block[i * row_size + num_bytes];
+            row[num_bytes] = (uint8_t)((row[num_bytes] & ~mask) | (bits & mask));
+        }
+    }
+}
+
+void transpose_bit_8xN_bits(uint8_t* dst, const uint8_t* const* src, size_t num_cols) {
+    transpose_bit_kxN_bits(8, dst, src, num_cols);
+}
+
+void transpose_bit_Nx8_bits(uint8_t** dst, const uint8_t* src, size_t num_rows) {
+    transpose_bit_Nxk_bits(8, dst, src, num_rows);
+}
+
+void transpose_bit_16xN_bits(uint16_t* dst, const uint8_t* const* src, size_t num_cols) {
+    transpose_bit_kxN_bits(16, (uint8_t*)(dst), src, num_cols);
+}
+
+void transpose_bit_Nx16_bits(uint8_t** dst, const uint16_t* src, size_t num_rows) {
+    transpose_bit_Nxk_bits(16, dst, (const uint8_t*)(src), num_rows);
+}
+
+void transpose_bit_32xN_bits(uint32_t* dst, const uint8_t* const* src, size_t num_cols) {
+    transpose_bit_kxN_bits(32, (uint8_t*)(dst), src, num_cols);
+}
+
+void transpose_bit_Nx32_bits(uint8_t** dst, const uint32_t* src, size_t num_rows) {
+    transpose_bit_Nxk_bits(32, dst, (const uint8_t*)(src), num_rows);
+}
+
+void transpose_bit_64xN_bits(uint64_t* dst, const uint8_t* const* src, size_t num_cols) {
+    transpose_bit_kxN_bits(64, (uint8_t*)(dst), src, num_cols);
+}
+
+void transpose_bit_Nx64_bits(uint8_t** dst, const uint64_t* src, size_t num_rows) {
+    transpose_bit_Nxk_bits(64, dst, (const uint8_t*)(src), num_rows);
+}
+
+void transpose_bit_128xN_bits(uint8_t* dst, const uint8_t* const* src, size_t num_cols) {
+    transpose_bit_kxN_bits(128, dst, src, num_cols);
+}
+
+void transpose_bit_Nx128_bits(uint8_t** dst, const uint8_t* src, size_t num_rows) {
+    transpose_bit_Nxk_bits(128, dst, src, num_rows);
+}
+
+/* The transpositions for arbitrary k split the rows into groups of 8, 16, 32,
+ * 64 or 128 rows (the last one possibly padded), and process the columns in
+ * chunks of this size, such that the output (input) of each group fits into a
+ * staging buffer of 8 KiB. */
+#define RUNTIME_K_CHUNK_SIZE 512
+
+/* Return the size of the next group of rows if remaining rows are left, i.e.,
+ * the largest supported k not exceeding them (but at least 8). */
+static size_t row_group_size(size_t remaining) {
+    size_t size = 128;
+    while (size > 8 && size > remaining) {
+        size /= 2;
+    }
+    return size;
+}
+
+/* Copy num_rows rows of row_size bytes (1, 2, 4, 8 or 16) between buffers with
+ * different strides.  With fixed sizes, the copies are single moves. */
+static void copy_rows(uint8_t* dst, size_t dst_stride, const uint8_t* src, size_t src_stride,
+                      size_t row_size, size_t num_rows) {
+    switch (row_size) {
+        case 1:
+            for (size_t i = 0; i < num_rows; ++i) {
+                dst[i * dst_stride] = src[i * src_stride];
+            }
+            break;
+        case 2:
+            for (size_t i = 0; i < num_rows; ++i) {
+                memcpy(dst + i * dst_stride, src + i * src_stride, 2);
+            }
+            break;
+        case 4:
+            for (size_t i = 0; i < num_rows; ++i) {
+                memcpy(dst + i * dst_stride, src + i * src_stride, 4);
+            }
+            break;
+        case 8:
+            for (size_t i = 0; i < num_rows; ++i) {
+                memcpy(dst + i * dst_stride, src + i * src_stride, 8);
+            }
+            break;
+        case 16:
+            for (size_t i = 0; i < num_rows; ++i) {
+                memcpy(dst + i * dst_stride, src + i * src_stride, 16);
+            }
+            break;
+    }
+}
+
+void transpose_bit_kxN(uint8_t* dst, const uint8_t* const* src, size_t k, size_t num_cols) {
+    if (k == row_group_size(k)) {
+        transpose_bit_kxN_bits(k, dst, src, num_cols);
+        return;
+    }
+    const size_t row_size = (k + 7) / 8;
+    uint64_t staging_words[RUNTIME_K_CHUNK_SIZE * 2];
+    /* the padding rows of a group are read from a row of zeros */
+    const uint8_t zeros[RUNTIME_K_CHUNK_SIZE / 8] = {0};
+    const uint8_t* group_src[128];
+    for (size_t col = 0; col < num_cols; col += RUNTIME_K_CHUNK_SIZE) {
+        const size_t chunk_cols =
+            num_cols - col < RUNTIME_K_CHUNK_SIZE ? num_cols - col : RUNTIME_K_CHUNK_SIZE;
+        for (size_t row = 0; row < k;) {
+            const size_t group_size = row_group_size(k - row);
+            const size_t group_rows = k - row < group_size ? k - row : group_size;
+            for (size_t i = 0; i < group_size; ++i) {
+                group_src[i] = i < group_rows ? src[row + i] + col / 8 : zeros;
+            }
+            uint8_t* group_dst = dst + col * row_size + row / 8;
+            if (group_size / 8 == row_size) {
+                /* a single group (k < 8) can be written directly */
+                transpose_bit_kxN_bits(group_size, group_dst, group_src, chunk_cols);
+            } else {
+                uint8_t* staging = (uint8_t*)(staging_words);
+                transpose_bit_kxN_bits(group_size, staging, group_src, chunk_cols);
+                copy_rows(group_dst, row_size, staging, group_size / 8, group_size / 8,
+                          chunk_cols);
+            }
+            row += group_rows;
+        }
+    }
+}
+
+void transpose_bit_Nxk(uint8_t** dst, const uint8_t* src, size_t k, size_t num_rows) {
+    if (k == row_group_size(k)) {
+        transpose_bit_Nxk_bits(k, dst, src, num_rows);
+        return;
+    }
+    const size_t row_size = (k + 7) / 8;
+    uint64_t staging_words[RUNTIME_K_CHUNK_SIZE * 2];
+    /* the padding rows of a group are written to a scratch row */
+    uint8_t scratch[RUNTIME_K_CHUNK_SIZE / 8] = {0};
+    uint8_t* group_dst[128];
+    for (size_t col = 0; col < num_rows; col += RUNTIME_K_CHUNK_SIZE) {
+        const size_t chunk_cols =
+            num_rows - col < RUNTIME_K_CHUNK_SIZE ? num_rows - col : RUNTIME_K_CHUNK_SIZE;
+        for (size_t row = 0; row < k;) {
+            const size_t group_size = row_group_size(k - row);
+            const size_t group_rows = k - row < group_size ? k - row : group_size;
+            for (size_t i = 0; i < group_size; ++i) {
+                group_dst[i] = i < group_rows ? dst[row + i] + col / 8 : scratch;
+            }
+            const uint8_t* group_src = src + col * row_size + row / 8;
+            if (group_size / 8 == row_size) {
+                /* a single group (k < 8) can be read directly */
+                transpose_bit_Nxk_bits(group_size, group_dst, group_src, chunk_cols);
+            } else {
+                uint8_t* staging = (uint8_t*)(staging_words);
+                copy_rows(staging, group_size / 8, group_src, row_size, group_size / 8,
+                          chunk_cols);
+                transpose_bit_Nxk_bits(group_size, group_dst, staging, chunk_cols);
+            }
+            row += group_rows;
+        }
+    }
+}
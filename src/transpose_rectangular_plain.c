@@ -21,6 +21,7 @@
  * SOFTWARE.
  */
 
+#include "bit_transpose_backend.h"
 #include "bit_transpose.h"
 
 #include <stddef.h>
@@ -125,3 +126,60 @@ void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
         }
     }
 }
+
+/* plain C offers no streaming stores, so the _nt variants use regular ones */
+
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
+}
+
+/* the plain C functions work on any alignment, so the _aligned variants are the
+ * regular ones */
+
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_8xN(dst, src, N);
+}
+
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx8(dst, src, N);
+}
+
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_16xN(dst, src, N);
+}
+
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N) {
+    transpose_bit_Nx16(dst, src, N);
+}
+
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_32xN(dst, src, N);
+}
+
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N) {
+    transpose_bit_Nx32(dst, src, N);
+}
+
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nx64(dst, src, N);
+}
+
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
+}
@@ -0,0 +1,680 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_extra_ssse3.h"
+#include "bit_transpose_prefetch.h"
+#include "bit_transpose_stream.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+/* transpose a 4x4 matrix of 32 bit words */
+static inline void transpose_epi32_4x4(__m128i* a, __m128i* b, __m128i* c, __m128i* d) {
+    __m128i tmp_0 = _mm_unpacklo_epi32(*a, *b);
+    __m128i tmp_1 = _mm_unpacklo_epi32(*c, *d);
+    __m128i tmp_2 = _mm_unpackhi_epi32(*a, *b);
+    __m128i tmp_3 = _mm_unpackhi_epi32(*c, *d);
+    *a = _mm_unpacklo_epi64(tmp_0, tmp_1);
+    *b = _mm_unpackhi_epi64(tmp_0, tmp_1);
+    *c = _mm_unpacklo_epi64(tmp_2, tmp_3);
+    *d = _mm_unpackhi_epi64(tmp_2, tmp_3);
+}
+
+void transpose_bit_8xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    /* shuffle mask used below */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0b07030e0a0602, 0x0d0905010c080400);
+
+    /* transposition of a 8xN matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 8x8 blocks */
+        uint32_t words[8];
+        /* load 4 words from each row */
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(&words[i], src[i] + 4 * superblock_i, 4);
+        }
+        __m128i upper = _mm_loadu_si128((const __m128i*)&words[0]);
+        __m128i lower = _mm_loadu_si128((const __m128i*)&words[4]);
+        /* shuffle the bytes */
+        /* [FEDC BA98 7654 3210] -> [FB73 EA62 D951 C840] */
+        upper = _mm_shuffle_epi8(upper, shuffle_mask);
+        lower = _mm_shuffle_epi8(lower, shuffle_mask);
+        /* interleave the 32 bit words of the upper and lower half */
+        /* now each 64 bit word contains a 8x8 submatrix which we transpose separately */
+        __m128i blocks_01 = _mm_unpacklo_epi32(upper, lower);
+        __m128i blocks_23 = _mm_unpackhi_epi32(upper, lower);
+        blocks_01 = transpose_bit_8x8_packed_x2_direct(blocks_01);
+        blocks_23 = transpose_bit_8x8_packed_x2_direct(blocks_23);
+        _mm_storeu_si128((__m128i*)&dst[32 * superblock_i], blocks_01);
+        _mm_storeu_si128((__m128i*)&dst[32 * superblock_i + 16], blocks_23);
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 4 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            block |= (uint64_t)(src[i][block_i]) << (i * 8);
+        }
+        block = transpose_bit_8x8_direct(block);
+        memcpy(&dst[8 * block_i], &block, 8);
+    }
+}
+
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_8xN(dst, src, N);
+}
+
+void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* shuffle mask used below */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0b07030e0a0602, 0x0d0905010c080400);
+
+    /* transposition of a Nx8 matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 8x8 blocks */
+        /* load 4 blocks */
+        __m128i blocks_01 = _mm_loadu_si128((const __m128i*)&src[32 * superblock_i]);
+        __m128i blocks_23 = _mm_loadu_si128((const __m128i*)&src[32 * superblock_i + 16]);
+        /* each 64 bit word contains a 8x8 submatrix which we transpose separately */
+        blocks_01 = transpose_bit_8x8_packed_x2_direct(blocks_01);
+        blocks_23 = transpose_bit_8x8_packed_x2_direct(blocks_23);
+        /* collect the upper and lower halves of the blocks */
+        /* [3 2 1 0] -> [3 1 2 0] */
+        blocks_01 = _mm_shuffle_epi32(blocks_01, 0b11011000);
+        blocks_23 = _mm_shuffle_epi32(blocks_23, 0b11011000);
+        __m128i upper = _mm_unpacklo_epi64(blocks_01, blocks_23);
+        __m128i lower = _mm_unpackhi_epi64(blocks_01, blocks_23);
+        /* shuffle the bytes */
+        /* [FEDC BA98 7654 3210] -> [FB73 EA62 D951 C840] */
+        upper = _mm_shuffle_epi8(upper, shuffle_mask);
+        lower = _mm_shuffle_epi8(lower, shuffle_mask);
+        /* store 4 words into each row */
+        uint32_t words[8];
+        _mm_storeu_si128((__m128i*)&words[0], upper);
+        _mm_storeu_si128((__m128i*)&words[4], lower);
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(dst[i] + 4 * superblock_i, &words[i], 4);
+        }
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 4 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block;
+        memcpy(&block, &src[8 * block_i], 8);
+        block = transpose_bit_8x8_direct(block);
+        for (size_t i = 0; i < 8; ++i) {
+            dst[i][block_i] = (block >> (i * 8)) & 0xff;
+        }
+    }
+}
+
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx8(dst, src, N);
+}
+
+static void transpose_bit_16xN_onebyone(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 16x16 blocks */
+        uint16_t words[16];
+        __m128i vec[2];
+        /* load a word from each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(&words[i], src[i] + 2 * block_i, 2);
+        }
+        vec[0] = _mm_loadu_si128((const __m128i*)&words[0]);
+        vec[1] = _mm_loadu_si128((const __m128i*)&words[8]);
+        transpose_bit_16x16_xmm(vec, vec);
+        memcpy(&dst[block_i * 16], vec, 32);
+    }
+}
+
+void transpose_bit_16xN(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* batched implementation */
+
+    /* interleave the 16 bit words of two rows */
+    /* [FEDC BA98 7654 3210] -> [FE76 DC54 BA32 9810] */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0e07060d0c0504, 0x0b0a030209080100);
+
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 16x16 blocks */
+        __m128i vec[8];
+        /* load 4 words from each row, two rows per register */
+        for (size_t j = 0; j < 8; ++j) {
+            __m128i row_0 = _mm_loadl_epi64((const __m128i*)(src[2 * j] + 8 * superblock_i));
+            __m128i row_1 = _mm_loadl_epi64((const __m128i*)(src[2 * j + 1] + 8 * superblock_i));
+            vec[j] = _mm_shuffle_epi8(_mm_unpacklo_epi64(row_0, row_1), shuffle_mask);
+        }
+        /* now the k-th 32 bit word of vec[j] contains the k-th words of rows 2j and 2j+1 */
+        /* transposing the 32 bit words gathers the rows of each block */
+        transpose_epi32_4x4(&vec[0], &vec[1], &vec[2], &vec[3]);
+        transpose_epi32_4x4(&vec[4], &vec[5], &vec[6], &vec[7]);
+        for (size_t k = 0; k < 4; ++k) {
+            __m128i block[2] = {vec[k], vec[4 + k]};
+            transpose_bit_16x16_xmm(block, block);
+            memcpy(&dst[(4 * superblock_i + k) * 16], block, 32);
+        }
+    }
+    /* process the remaining 16x16 blocks */
+    uint16_t* rest_dst = dst + 4 * num_super_blocks * 16;
+    const uint8_t* rest_src[16];
+    for (size_t i = 0; i < 16; ++i) {
+        rest_src[i] = src[i] + 2 * 4 * num_super_blocks;
+    }
+    transpose_bit_16xN_onebyone(rest_dst, rest_src, num_rest);
+}
+
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_16xN(dst, src, N);
+}
+
+static void transpose_bit_Nx16_onebyone(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx16 matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 16x16 blocks */
+        uint16_t words[16];
+        __m128i vec[2];
+        memcpy(vec, &src[block_i * 16], 32);
+        transpose_bit_16x16_xmm(vec, vec);
+        _mm_storeu_si128((__m128i*)&words[0], vec[0]);
+        _mm_storeu_si128((__m128i*)&words[8], vec[1]);
+        /* store a word into each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(dst[i] + 2 * block_i, &words[i], 2);
+        }
+    }
+}
+
+void transpose_bit_Nx16(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* batched implementation */
+
+    /* deinterleave the 16 bit words of two rows */
+    /* [FEDC BA98 7654 3210] -> [FEBA 7632 DC98 5410] */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0e0b0a07060302, 0x0d0c090805040100);
+
+    /* transposition of a Nx16 matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 16x16 blocks */
+        __m128i vec[8];
+        /* load 4 16x16 matrices and transpose them */
+        for (size_t k = 0; k < 4; ++k) {
+            __m128i block[2];
+            memcpy(block, &src[(4 * superblock_i + k) * 16], 32);
+            transpose_bit_16x16_xmm(block, block);
+            vec[k] = block[0];
+            vec[4 + k] = block[1];
+        }
+        /* do the reverse permutations of those in the 16xN case */
+        transpose_epi32_4x4(&vec[0], &vec[1], &vec[2], &vec[3]);
+        transpose_epi32_4x4(&vec[4], &vec[5], &vec[6], &vec[7]);
+        /* store 4 words into each row */
+        for (size_t j = 0; j < 8; ++j) {
+            vec[j] = _mm_shuffle_epi8(vec[j], shuffle_mask);
+            _mm_storel_epi64((__m128i*)(dst[2 * j] + 8 * superblock_i), vec[j]);
+            _mm_storel_epi64((__m128i*)(dst[2 * j + 1] + 8 * superblock_i),
+                             _mm_unpackhi_epi64(vec[j], vec[j]));
+        }
+    }
+    /* process the remaining 16x16 blocks */
+    const uint16_t* rest_src = src + 4 * num_super_blocks * 16;
+    uint8_t* rest_dst[16];
+    for (size_t i = 0; i < 16; ++i) {
+        rest_dst[i] = dst[i] + 2 * 4 * num_super_blocks;
+    }
+    transpose_bit_Nx16_onebyone(rest_dst, rest_src, num_rest);
+}
+
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N) {
+    transpose_bit_Nx16(dst, src, N);
+}
+
+static void transpose_bit_32xN_onebyone(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 32xN matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 32x32 blocks */
+        uint32_t words[32];
+        __m128i vec[8];
+        /* load a word from each row */
+        for (size_t i = 0; i < 32; ++i) {
+            memcpy(&words[i], src[i] + 4 * block_i, 4);
+        }
+        memcpy(vec, words, 128);
+        transpose_bit_32x32_xmm(vec, vec);
+        memcpy(&dst[32 * block_i], vec, 128);
+    }
+}
+
+static inline void transpose_bit_32xN_impl(uint32_t* dst, const uint8_t* const* src, size_t N,
+                                           const int aligned) {
+    /* batched implementation */
+
+    /* transposition of a 32xN matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 32x32 blocks */
+        __m128i vec[4][8];
+        /* load 4 words from each row */
+        for (size_t j = 0; j < 8; ++j) {
+            __m128i rows[4];
+            for (size_t i = 0; i < 4; ++i) {
+                rows[i] = _mm_loadu_si128((const __m128i*)(src[4 * j + i] + 16 * superblock_i));
+            }
+            /* the k-th register contains the k-th words of the four rows */
+            transpose_epi32_4x4(&rows[0], &rows[1], &rows[2], &rows[3]);
+            for (size_t k = 0; k < 4; ++k) {
+                vec[k][j] = rows[k];
+            }
+        }
+        if (aligned) {
+            /* write the transposed blocks directly */
+            __m128i* dst_p = (__m128i*)(&dst[128 * superblock_i]);
+            for (size_t k = 0; k < 4; ++k) {
+                transpose_bit_32x32_xmm(&dst_p[8 * k], vec[k]);
+            }
+        } else {
+            for (size_t k = 0; k < 4; ++k) {
+                transpose_bit_32x32_xmm(vec[k], vec[k]);
+            }
+            memcpy(&dst[128 * superblock_i], vec, 4 * 128);
+        }
+    }
+    /* process the remaining 32x32 blocks */
+    uint32_t* rest_dst = dst + 4 * num_super_blocks * 32;
+    const uint8_t* rest_src[32];
+    for (size_t i = 0; i < 32; ++i) {
+        rest_src[i] = src[i] + 4 * 4 * num_super_blocks;
+    }
+    transpose_bit_32xN_onebyone(rest_dst, rest_src, num_rest);
+}
+
+void transpose_bit_32xN(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 16)) {
+        transpose_bit_32xN_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_32xN_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_32xN_impl(dst, src, N, 1);
+}
+
+static void transpose_bit_Nx32_onebyone(uint8_t** dst, const uint32_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 32x32 blocks */
+        __m128i vec[8];
+        uint32_t words[32];
+        memcpy(vec, src + block_i * 32, 128);
+        transpose_bit_32x32_xmm(vec, vec);
+        memcpy(words, vec, 128);
+        /* store a word into each row */
+        for (size_t i = 0; i < 32; ++i) {
+            memcpy(dst[i] + 4 * block_i, &words[i], 4);
+        }
+    }
+}
+
+static inline void transpose_bit_Nx32_impl(uint8_t** dst, const uint32_t* src, size_t N,
+                                           const int aligned) {
+    /* batched implementation */
+
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    size_t num_rest = N % 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 32x32 blocks */
+        __m128i vec[4][8];
+        /* load four 32x32 matrices and transpose them */
+        if (aligned) {
+            const __m128i* src_p = (const __m128i*)(&src[128 * superblock_i]);
+            for (size_t k = 0; k < 4; ++k) {
+                transpose_bit_32x32_xmm(vec[k], &src_p[8 * k]);
+            }
+        } else {
+            memcpy(vec, &src[128 * superblock_i], 4 * 128);
+            for (size_t k = 0; k < 4; ++k) {
+                transpose_bit_32x32_xmm(vec[k], vec[k]);
+            }
+        }
+        /* store 4 words into each row */
+        for (size_t j = 0; j < 8; ++j) {
+            __m128i rows[4] = {vec[0][j], vec[1][j], vec[2][j], vec[3][j]};
+            transpose_epi32_4x4(&rows[0], &rows[1], &rows[2], &rows[3]);
+            for (size_t i = 0; i < 4; ++i) {
+                _mm_storeu_si128((__m128i*)(dst[4 * j + i] + 16 * superblock_i), rows[i]);
+            }
+        }
+    }
+    /* process the remaining 32x32 blocks */
+    const uint32_t* rest_src = src + 4 * num_super_blocks * 32;
+    uint8_t* rest_dst[32];
+    for (size_t i = 0; i < 32; ++i) {
+        rest_dst[i] = dst[i] + 4 * 4 * num_super_blocks;
+    }
+    transpose_bit_Nx32_onebyone(rest_dst, rest_src, num_rest);
+}
+
+void transpose_bit_Nx32(uint8_t** dst, const uint32_t* src, size_t N) {
+    if (is_aligned_to(src, 16)) {
+        transpose_bit_Nx32_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_Nx32_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N) {
+    transpose_bit_Nx32_impl(dst, src, N, 1);
+}
+
+static void transpose_bit_64xN_onebyone(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a 64xN matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 64x64 blocks */
+        __m128i vec[32];
+        /* load a word from each row, two rows per register */
+        for (size_t j = 0; j < 32; ++j) {
+            __m128i row_0 = _mm_loadl_epi64((const __m128i*)(src[2 * j] + 8 * block_i));
+            __m128i row_1 = _mm_loadl_epi64((const __m128i*)(src[2 * j + 1] + 8 * block_i));
+            vec[j] = _mm_unpacklo_epi64(row_0, row_1);
+        }
+        transpose_bit_64x64_xmm(vec, vec);
+        memcpy(&dst[64 * block_i], vec, 512);
+    }
+}
+
+static inline void transpose_bit_64xN_impl(uint64_t* dst, const uint8_t* const* src, size_t N,
+                                           const int stream, const int aligned) {
+    /* batched implementation */
+
+    /* transposition of a 64xN matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    size_t num_rest = N % 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 64x64 blocks */
+        __m128i vec[2][32];
+        prefetch_rows(src, 64, 16 * superblock_i, 16, 8 * N);
+        /* load 2 words from each row */
+        for (size_t j = 0; j < 32; ++j) {
+            __m128i row_0 = _mm_loadu_si128((const __m128i*)(src[2 * j] + 16 * superblock_i));
+            __m128i row_1 = _mm_loadu_si128((const __m128i*)(src[2 * j + 1] + 16 * superblock_i));
+            vec[0][j] = _mm_unpacklo_epi64(row_0, row_1);
+            vec[1][j] = _mm_unpackhi_epi64(row_0, row_1);
+        }
+        __m128i* dst_p = (__m128i*)(&dst[128 * superblock_i]);
+        if (stream) {
+            transpose_bit_64x64_xmm(vec[0], vec[0]);
+            transpose_bit_64x64_xmm(vec[1], vec[1]);
+            for (size_t j = 0; j < 32; ++j) {
+                _mm_stream_si128(&dst_p[j], vec[0][j]);
+                _mm_stream_si128(&dst_p[32 + j], vec[1][j]);
+            }
+        } else if (aligned) {
+            /* write the transposed blocks directly */
+            transpose_bit_64x64_xmm(&dst_p[0], vec[0]);
+            transpose_bit_64x64_xmm(&dst_p[32], vec[1]);
+        } else {
+            transpose_bit_64x64_xmm(vec[0], vec[0]);
+            transpose_bit_64x64_xmm(vec[1], vec[1]);
+            memcpy(dst_p, vec, 2 * 512);
+        }
+    }
+    /* process the remaining 64x64 block */
+    uint64_t* rest_dst = dst + 2 * num_super_blocks * 64;
+    const uint8_t* rest_src[64];
+    for (size_t i = 0; i < 64; ++i) {
+        rest_src[i] = src[i] + 2 * 8 * num_super_blocks;
+    }
+    transpose_bit_64xN_onebyone(rest_dst, rest_src, num_rest);
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(512 * N)) {
+        transpose_bit_64xN_nt(dst, src, N);
+    } else if (is_aligned_to(dst, 16)) {
+        transpose_bit_64xN_impl(dst, src, N, 0, 1);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0, 0);
+    }
+}
+
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(512 * N)) {
+        transpose_bit_64xN_impl(dst, src, N, 1, 1);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0, 1);
+    }
+}
+
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 16)) {
+        transpose_bit_64xN_impl(dst, src, N, 1, 1);
+    } else {
+        transpose_bit_64xN_impl(dst, src, N, 0, 0);
+    }
+}
+
+static void transpose_bit_Nx64_onebyone(uint8_t** dst, const uint64_t* src, size_t N) {
+    /* one-by-one implementation */
+
+    /* transposition of a Nx64 matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 64x64 blocks */
+        __m128i vec[32];
+        memcpy(vec, src + block_i * 64, 512);
+        transpose_bit_64x64_xmm(vec, vec);
+        /* store a word into each row, two rows per register */
+        for (size_t j = 0; j < 32; ++j) {
+            _mm_storel_epi64((__m128i*)(dst[2 * j] + 8 * block_i), vec[j]);
+            _mm_storel_epi64((__m128i*)(dst[2 * j + 1] + 8 * block_i),
+                             _mm_unpackhi_epi64(vec[j], vec[j]));
+        }
+    }
+}
+
+static inline void transpose_bit_Nx64_impl(uint8_t** dst, const uint64_t* src, size_t N,
+                                           const int aligned) {
+    /* batched implementation */
+
+    /* transposition of a Nx64 matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    size_t num_rest = N % 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 64x64 blocks */
+        __m128i vec[2][32];
+        /* load two 64x64 matrices and transpose them */
+        if (aligned) {
+            const __m128i* src_p = (const __m128i*)(&src[128 * superblock_i]);
+            transpose_bit_64x64_xmm(vec[0], &src_p[0]);
+            transpose_bit_64x64_xmm(vec[1], &src_p[32]);
+        } else {
+            memcpy(vec, &src[128 * superblock_i], 2 * 512);
+            transpose_bit_64x64_xmm(vec[0], vec[0]);
+            transpose_bit_64x64_xmm(vec[1], vec[1]);
+        }
+        /* store 2 words into each row */
+        for (size_t j = 0; j < 32; ++j) {
+            __m128i row_0 = _mm_unpacklo_epi64(vec[0][j], vec[1][j]);
+            __m128i row_1 = _mm_unpackhi_epi64(vec[0][j], vec[1][j]);
+            _mm_storeu_si128((__m128i*)(dst[2 * j] + 16 * superblock_i), row_0);
+            _mm_storeu_si128((__m128i*)(dst[2 * j + 1] + 16 * superblock_i), row_1);
+        }
+    }
+    /* process the remaining 64x64 block */
+    const uint64_t* rest_src = src + 2 * num_super_blocks * 64;
+    uint8_t* rest_dst[64];
+    for (size_t i = 0; i < 64; ++i) {
+        rest_dst[i] = dst[i] + 2 * 8 * num_super_blocks;
+    }
+    transpose_bit_Nx64_onebyone(rest_dst, rest_src, num_rest);
+}
+
+void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
+    if (is_aligned_to(src, 16)) {
+        transpose_bit_Nx64_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_Nx64_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nx64_impl(dst, src, N, 1);
+}
+
+static inline void transpose_bit_128xN_impl(uint8_t* dst, const uint8_t* const* src, size_t N,
+                                            const int stream, const int aligned) {
+    /* transposition of a 128xN matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    /* - each row of a block fills exactly one register, so there is nothing to gain from
+     *   processing multiple blocks at once */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 128x128 blocks */
+        __m128i vec[128];
+        prefetch_rows(src, 128, 16 * block_i, 16, 16 * N);
+        /* load a word from each row */
+        for (size_t j = 0; j < 128; ++j) {
+            vec[j] = _mm_loadu_si128((const __m128i*)(src[j] + 16 * block_i));
+        }
+        __m128i* dst_p = (__m128i*)(&dst[2048 * block_i]);
+        if (stream) {
+            transpose_bit_128x128_xmm(vec, vec);
+            for (size_t j = 0; j < 128; ++j) {
+                _mm_stream_si128(&dst_p[j], vec[j]);
+            }
+        } else if (aligned) {
+            /* write the transposed block directly */
+            transpose_bit_128x128_xmm(dst_p, vec);
+        } else {
+            transpose_bit_128x128_xmm(vec, vec);
+            memcpy(dst_p, vec, 2048);
+        }
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
+void transpose_bit_128xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_128xN_nt(dst, src, N);
+    } else if (is_aligned_to(dst, 16)) {
+        transpose_bit_128xN_impl(dst, src, N, 0, 1);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0, 0);
+    }
+}
+
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (use_streaming_stores(2048 * N)) {
+        transpose_bit_128xN_impl(dst, src, N, 1, 1);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0, 1);
+    }
+}
+
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    if (is_aligned_to(dst, 16)) {
+        transpose_bit_128xN_impl(dst, src, N, 1, 1);
+    } else {
+        transpose_bit_128xN_impl(dst, src, N, 0, 0);
+    }
+}
+
+static inline void transpose_bit_Nx128_impl(uint8_t** dst, const uint8_t* src, size_t N,
+                                            const int aligned) {
+    /* transposition of a Nx128 matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    for (size_t block_i = 0; block_i < N; ++block_i) {
+        /* transpose 128x128 blocks */
+        __m128i vec[128];
+        if (aligned) {
+            transpose_bit_128x128_xmm(vec, (const __m128i*)(src + 2048 * block_i));
+        } else {
+            memcpy(vec, src + 2048 * block_i, 2048);
+            transpose_bit_128x128_xmm(vec, vec);
+        }
+        /* store a word into each row */
+        for (size_t j = 0; j < 128; ++j) {
+            _mm_storeu_si128((__m128i*)(dst[j] + 16 * block_i), vec[j]);
+        }
+    }
+}
+
+void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
+    if (is_aligned_to(src, 16)) {
+        transpose_bit_Nx128_impl(dst, src, N, 1);
+    } else {
+        transpose_bit_Nx128_impl(dst, src, N, 0);
+    }
+}
+
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128_impl(dst, src, N, 1);
+}
+
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* every row receives only 16 bytes per block, i.e., a fraction of a cache line, so
+     * that streaming stores would write partial lines to memory */
+    transpose_bit_Nx128(dst, src, N);
+}
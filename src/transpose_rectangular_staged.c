@@ -0,0 +1,64 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose.h"
+#include "bit_transpose_generic.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Variants of the Nxk transpositions which stage the output in a small tile
+ * and copy it to the rows of dst in bursts.  They are built on top of the Nxk
+ * functions, do not depend on the backend and are compiled once. */
+
+/* Size of the staging tile in bytes.  It holds STAGED_TILE_SIZE / k / k
+ * consecutive blocks, i.e., each row of dst receives 256 (Nx64) or 128
+ * (Nx128) bytes per burst. */
+#define STAGED_TILE_SIZE 16384
+
+static void transpose_bit_Nxk_staged(size_t k, uint8_t** dst, const uint8_t* src, size_t N) {
+    uint64_t staging_words[STAGED_TILE_SIZE / 8];
+    uint8_t* staging = (uint8_t*)(staging_words);
+    const size_t row_size = k / 8;
+    const size_t tile_blocks = STAGED_TILE_SIZE / (k * row_size);
+    uint8_t* staging_rows[128];
+    for (size_t i = 0; i < k; ++i) {
+        staging_rows[i] = staging + i * tile_blocks * row_size;
+    }
+    for (size_t block_i = 0; block_i < N; block_i += tile_blocks) {
+        const size_t num_blocks = N - block_i < tile_blocks ? N - block_i : tile_blocks;
+        transpose_bit_Nxk_rows(k, staging_rows, src + block_i * k * row_size, num_blocks);
+        for (size_t i = 0; i < k; ++i) {
+            memcpy(dst[i] + block_i * row_size, staging_rows[i], num_blocks * row_size);
+        }
+    }
+}
+
+void transpose_bit_Nx64_staged(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nxk_staged(64, dst, (const uint8_t*)(src), N);
+}
+
+void transpose_bit_Nx128_staged(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nxk_staged(128, dst, src, N);
+}
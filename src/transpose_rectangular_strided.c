@@ -0,0 +1,146 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose.h"
+#include "bit_transpose_generic.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Rectangular transpositions of strided matrices built on top of the kxN and
+ * Nxk functions.  They do not depend on the backend and are compiled once. */
+
+/* Size of the buffer used to stage the output (or input) of the tall side of
+ * the strided transpositions if its rows are not packed. */
+#define STRIDED_STAGING_SIZE 8192
+
+static void transpose_bit_kxN_strided(size_t k, uint8_t* dst, size_t dst_stride,
+                                      const uint8_t* src, size_t src_stride, size_t N) {
+    /* the rows of the wide side are addressed once per call */
+    const uint8_t* src_rows[128];
+    for (size_t i = 0; i < k; ++i) {
+        src_rows[i] = src + i * src_stride;
+    }
+    const size_t row_size = k / 8;
+    if (dst_stride == row_size) {
+        transpose_bit_kxN_rows(k, dst, src_rows, N);
+        return;
+    }
+    /* otherwise, transpose chunks of blocks into a packed buffer and copy the
+     * rows from there */
+    uint64_t staging_words[STRIDED_STAGING_SIZE / 8];
+    uint8_t* staging = (uint8_t*)(staging_words);
+    const size_t block_size = k * row_size;
+    const size_t chunk_blocks = STRIDED_STAGING_SIZE / block_size;
+    for (size_t block_i = 0; block_i < N; block_i += chunk_blocks) {
+        const size_t num_blocks = N - block_i < chunk_blocks ? N - block_i : chunk_blocks;
+        transpose_bit_kxN_rows(k, staging, src_rows, num_blocks);
+        for (size_t j = 0; j < k * num_blocks; ++j) {
+            memcpy(dst + (k * block_i + j) * dst_stride, staging + j * row_size, row_size);
+        }
+        for (size_t i = 0; i < k; ++i) {
+            src_rows[i] += num_blocks * row_size;
+        }
+    }
+}
+
+static void transpose_bit_Nxk_strided(size_t k, uint8_t* dst, size_t dst_stride,
+                                      const uint8_t* src, size_t src_stride, size_t N) {
+    /* the rows of the wide side are addressed once per call */
+    uint8_t* dst_rows[128];
+    for (size_t i = 0; i < k; ++i) {
+        dst_rows[i] = dst + i * dst_stride;
+    }
+    const size_t row_size = k / 8;
+    if (src_stride == row_size) {
+        transpose_bit_Nxk_rows(k, dst_rows, src, N);
+        return;
+    }
+    /* otherwise, copy chunks of blocks into a packed buffer and transpose them
+     * from there */
+    uint64_t staging_words[STRIDED_STAGING_SIZE / 8];
+    uint8_t* staging = (uint8_t*)(staging_words);
+    const size_t block_size = k * row_size;
+    const size_t chunk_blocks = STRIDED_STAGING_SIZE / block_size;
+    for (size_t block_i = 0; block_i < N; block_i += chunk_blocks) {
+        const size_t num_blocks = N - block_i < chunk_blocks ? N - block_i : chunk_blocks;
+        for (size_t j = 0; j < k * num_blocks; ++j) {
+            memcpy(staging + j * row_size, src + (k * block_i + j) * src_stride, row_size);
+        }
+        transpose_bit_Nxk_rows(k, dst_rows, staging, num_blocks);
+        for (size_t i = 0; i < k; ++i) {
+            dst_rows[i] += num_blocks * row_size;
+        }
+    }
+}
+
+void transpose_bit_8xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                               size_t src_stride, size_t N) {
+    transpose_bit_kxN_strided(8, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_Nx8_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                               size_t src_stride, size_t N) {
+    transpose_bit_Nxk_strided(8, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_16xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_kxN_strided(16, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_Nx16_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_Nxk_strided(16, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_32xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_kxN_strided(32, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_Nx32_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_Nxk_strided(32, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_64xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_kxN_strided(64, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_Nx64_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                size_t src_stride, size_t N) {
+    transpose_bit_Nxk_strided(64, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_128xN_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                 size_t src_stride, size_t N) {
+    transpose_bit_kxN_strided(128, dst, dst_stride, src, src_stride, N);
+}
+
+void transpose_bit_Nx128_strided(uint8_t* dst, size_t dst_stride, const uint8_t* src,
+                                 size_t src_stride, size_t N) {
+    transpose_bit_Nxk_strided(128, dst, dst_stride, src, src_stride, N);
+}
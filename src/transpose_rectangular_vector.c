@@ -0,0 +1,448 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_extra_vector.h"
+#include "bit_transpose_prefetch.h"
+
+#include <string.h>
+
+/* The kxN functions process two kxk blocks at once: two words of each row are
+ * loaded, and the blocks are separated by splitting the vectors into their
+ * even and odd words (see transpose_square_vector.c).  The Nxk functions do
+ * the inverse.
+ */
+
+static inline uint64_t load_u64(const uint8_t* src) {
+    uint64_t word;
+    memcpy(&word, src, 8);
+    return word;
+}
+
+static inline void store_u64(uint8_t* dst, uint64_t word) {
+    memcpy(dst, &word, 8);
+}
+
+void transpose_bit_8xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    /* transposition of a 8xN matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 8x8 blocks */
+        uint32_t words[8];
+        u8x32 vec;
+        /* load 4 words from each row */
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(&words[i], src[i] + 4 * superblock_i, 4);
+        }
+        memcpy(&vec, words, 32);
+        /* gather the bytes of each block in a 64 bit word */
+        vec = SHUFFLE(u8x32, vec, vec, 0, 4, 8, 12, 16, 20, 24, 28, 1, 5, 9, 13, 17, 21, 25, 29, 2,
+                      6, 10, 14, 18, 22, 26, 30, 3, 7, 11, 15, 19, 23, 27, 31);
+        u64x4 blocks = (u64x4)vec;
+        transpose_bit_8x8_packed_x4_vec(&blocks);
+        memcpy(&dst[32 * superblock_i], &blocks, 32);
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 4 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            block |= (uint64_t)(src[i][block_i]) << (i * 8);
+        }
+        block = transpose_bit_8x8_direct(block);
+        memcpy(&dst[8 * block_i], &block, 8);
+    }
+}
+
+void transpose_bit_Nx8(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* transposition of a Nx8 matrix: */
+    /* - partition the matrix into blocks of size 8x8 */
+    /* - process as many as possible in super blocks of 4 */
+    size_t num_super_blocks = N / 4;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 4 8x8 blocks */
+        uint32_t words[8];
+        u64x4 blocks;
+        memcpy(&blocks, &src[32 * superblock_i], 32);
+        transpose_bit_8x8_packed_x4_vec(&blocks);
+        u8x32 vec = (u8x32)blocks;
+        /* gather the i-th bytes of the blocks in a 32 bit word */
+        vec = SHUFFLE(u8x32, vec, vec, 0, 8, 16, 24, 1, 9, 17, 25, 2, 10, 18, 26, 3, 11, 19, 27, 4,
+                      12, 20, 28, 5, 13, 21, 29, 6, 14, 22, 30, 7, 15, 23, 31);
+        memcpy(words, &vec, 32);
+        /* store 4 words into each row */
+        for (size_t i = 0; i < 8; ++i) {
+            memcpy(dst[i] + 4 * superblock_i, &words[i], 4);
+        }
+    }
+    /* process the remaining 8x8 blocks */
+    for (size_t block_i = 4 * num_super_blocks; block_i < N; ++block_i) {
+        uint64_t block;
+        memcpy(&block, &src[8 * block_i], 8);
+        block = transpose_bit_8x8_direct(block);
+        for (size_t i = 0; i < 8; ++i) {
+            dst[i][block_i] = (block >> (i * 8)) & 0xff;
+        }
+    }
+}
+
+void transpose_bit_16xN(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    /* transposition of a 16xN matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 16x16 blocks */
+        uint32_t words[16];
+        u16x16 vec[2];
+        /* load 2 words from each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(&words[i], src[i] + 4 * superblock_i, 4);
+        }
+        memcpy(vec, words, 64);
+        split_u16x16(&vec[0], &vec[1]);
+        transpose_bit_16x16_vec(&vec[0], &vec[0]);
+        transpose_bit_16x16_vec(&vec[1], &vec[1]);
+        memcpy(&dst[32 * superblock_i], vec, 64);
+    }
+    /* process the remaining 16x16 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        uint16_t words[16];
+        u16x16 vec;
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(&words[i], src[i] + 2 * block_i, 2);
+        }
+        memcpy(&vec, words, 32);
+        transpose_bit_16x16_vec(&vec, &vec);
+        memcpy(&dst[16 * block_i], &vec, 32);
+    }
+}
+
+void transpose_bit_Nx16(uint8_t** dst, const uint16_t* src, size_t N) {
+    /* transposition of a Nx16 matrix: */
+    /* - partition the matrix into blocks of size 16x16 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 16x16 blocks */
+        uint32_t words[16];
+        u16x16 vec[2];
+        memcpy(vec, &src[32 * superblock_i], 64);
+        transpose_bit_16x16_vec(&vec[0], &vec[0]);
+        transpose_bit_16x16_vec(&vec[1], &vec[1]);
+        merge_u16x16(&vec[0], &vec[1]);
+        memcpy(words, vec, 64);
+        /* store 2 words into each row */
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(dst[i] + 4 * superblock_i, &words[i], 4);
+        }
+    }
+    /* process the remaining 16x16 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        uint16_t words[16];
+        u16x16 vec;
+        memcpy(&vec, &src[16 * block_i], 32);
+        transpose_bit_16x16_vec(&vec, &vec);
+        memcpy(words, &vec, 32);
+        for (size_t i = 0; i < 16; ++i) {
+            memcpy(dst[i] + 2 * block_i, &words[i], 2);
+        }
+    }
+}
+
+void transpose_bit_32xN(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    /* transposition of a 32xN matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 32x32 blocks */
+        u32x8 vec[2][4];
+        /* load 2 words from each row, four rows per vector */
+        for (size_t j = 0; j < 4; ++j) {
+            for (size_t k = 0; k < 2; ++k) {
+                const size_t row = 8 * j + 4 * k;
+                u64x4 rows = {load_u64(src[row] + 8 * superblock_i),
+                              load_u64(src[row + 1] + 8 * superblock_i),
+                              load_u64(src[row + 2] + 8 * superblock_i),
+                              load_u64(src[row + 3] + 8 * superblock_i)};
+                vec[k][j] = (u32x8)rows;
+            }
+            split_u32x8(&vec[0][j], &vec[1][j]);
+        }
+        transpose_bit_32x32_vec(vec[0], vec[0]);
+        transpose_bit_32x32_vec(vec[1], vec[1]);
+        memcpy(&dst[64 * superblock_i], vec, 2 * 128);
+    }
+    /* process the remaining 32x32 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        uint32_t words[32];
+        u32x8 vec[4];
+        for (size_t i = 0; i < 32; ++i) {
+            memcpy(&words[i], src[i] + 4 * block_i, 4);
+        }
+        memcpy(vec, words, 128);
+        transpose_bit_32x32_vec(vec, vec);
+        memcpy(&dst[32 * block_i], vec, 128);
+    }
+}
+
+void transpose_bit_Nx32(uint8_t** dst, const uint32_t* src, size_t N) {
+    /* transposition of a Nx32 matrix: */
+    /* - partition the matrix into blocks of size 32x32 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 32x32 blocks */
+        u32x8 vec[2][4];
+        memcpy(vec, &src[64 * superblock_i], 2 * 128);
+        transpose_bit_32x32_vec(vec[0], vec[0]);
+        transpose_bit_32x32_vec(vec[1], vec[1]);
+        /* store 2 words into each row, four rows per vector */
+        for (size_t j = 0; j < 4; ++j) {
+            merge_u32x8(&vec[0][j], &vec[1][j]);
+            for (size_t k = 0; k < 2; ++k) {
+                const size_t row = 8 * j + 4 * k;
+                uint64_t words[4];
+                memcpy(words, &vec[k][j], 32);
+                for (size_t i = 0; i < 4; ++i) {
+                    memcpy(dst[row + i] + 8 * superblock_i, &words[i], 8);
+                }
+            }
+        }
+    }
+    /* process the remaining 32x32 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        uint32_t words[32];
+        u32x8 vec[4];
+        memcpy(vec, &src[32 * block_i], 128);
+        transpose_bit_32x32_vec(vec, vec);
+        memcpy(words, vec, 128);
+        for (size_t i = 0; i < 32; ++i) {
+            memcpy(dst[i] + 4 * block_i, &words[i], 4);
+        }
+    }
+}
+
+void transpose_bit_64xN(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    /* transposition of a 64xN matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 64x64 blocks */
+        u64x4 vec[2][16];
+        prefetch_rows(src, 64, 16 * superblock_i, 16, 8 * N);
+        /* load 2 words from each row, two rows per vector */
+        for (size_t j = 0; j < 16; ++j) {
+            for (size_t k = 0; k < 2; ++k) {
+                const uint8_t* row_0 = src[4 * j + 2 * k] + 16 * superblock_i;
+                const uint8_t* row_1 = src[4 * j + 2 * k + 1] + 16 * superblock_i;
+                vec[k][j] = (u64x4){load_u64(row_0), load_u64(row_0 + 8), load_u64(row_1),
+                                    load_u64(row_1 + 8)};
+            }
+            split_u64x4(&vec[0][j], &vec[1][j]);
+        }
+        transpose_bit_64x64_vec(vec[0], vec[0]);
+        transpose_bit_64x64_vec(vec[1], vec[1]);
+        memcpy(&dst[128 * superblock_i], vec, 2 * 512);
+    }
+    /* process the remaining 64x64 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        u64x4 vec[16];
+        for (size_t j = 0; j < 16; ++j) {
+            vec[j] = (u64x4){load_u64(src[4 * j] + 8 * block_i),
+                             load_u64(src[4 * j + 1] + 8 * block_i),
+                             load_u64(src[4 * j + 2] + 8 * block_i),
+                             load_u64(src[4 * j + 3] + 8 * block_i)};
+        }
+        transpose_bit_64x64_vec(vec, vec);
+        memcpy(&dst[64 * block_i], vec, 512);
+    }
+}
+
+void transpose_bit_Nx64(uint8_t** dst, const uint64_t* src, size_t N) {
+    /* transposition of a Nx64 matrix: */
+    /* - partition the matrix into blocks of size 64x64 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 64x64 blocks */
+        u64x4 vec[2][16];
+        memcpy(vec, &src[128 * superblock_i], 2 * 512);
+        transpose_bit_64x64_vec(vec[0], vec[0]);
+        transpose_bit_64x64_vec(vec[1], vec[1]);
+        /* store 2 words into each row, two rows per vector */
+        for (size_t j = 0; j < 16; ++j) {
+            merge_u64x4(&vec[0][j], &vec[1][j]);
+            for (size_t k = 0; k < 2; ++k) {
+                memcpy(dst[4 * j + 2 * k] + 16 * superblock_i, &vec[k][j], 16);
+                memcpy(dst[4 * j + 2 * k + 1] + 16 * superblock_i, (uint8_t*)&vec[k][j] + 16, 16);
+            }
+        }
+    }
+    /* process the remaining 64x64 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        u64x4 vec[16];
+        memcpy(vec, &src[64 * block_i], 512);
+        transpose_bit_64x64_vec(vec, vec);
+        for (size_t j = 0; j < 16; ++j) {
+            for (size_t i = 0; i < 4; ++i) {
+                store_u64(dst[4 * j + i] + 8 * block_i, vec[j][i]);
+            }
+        }
+    }
+}
+
+void transpose_bit_128xN(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    /* transposition of a 128xN matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 128x128 blocks */
+        u64x4 vec[2][64];
+        prefetch_rows(src, 128, 32 * superblock_i, 32, 16 * N);
+        /* load 2 words from each row, one row per vector */
+        for (size_t j = 0; j < 64; ++j) {
+            u64x4 row_0;
+            u64x4 row_1;
+            memcpy(&row_0, src[2 * j] + 32 * superblock_i, 32);
+            memcpy(&row_1, src[2 * j + 1] + 32 * superblock_i, 32);
+            /* separate the 128 bit words of the two rows */
+            vec[0][j] = SHUFFLE(u64x4, row_0, row_1, 0, 1, 4, 5);
+            vec[1][j] = SHUFFLE(u64x4, row_0, row_1, 2, 3, 6, 7);
+        }
+        transpose_bit_128x128_vec(vec[0], vec[0]);
+        transpose_bit_128x128_vec(vec[1], vec[1]);
+        memcpy(&dst[4096 * superblock_i], vec, 2 * 2048);
+    }
+    /* process the remaining 128x128 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        u64x4 vec[64];
+        for (size_t j = 0; j < 128; ++j) {
+            memcpy((uint8_t*)vec + 16 * j, src[j] + 16 * block_i, 16);
+        }
+        transpose_bit_128x128_vec(vec, vec);
+        memcpy(&dst[2048 * block_i], vec, 2048);
+    }
+}
+
+void transpose_bit_Nx128(uint8_t** dst, const uint8_t* src, size_t N) {
+    /* transposition of a Nx128 matrix: */
+    /* - partition the matrix into blocks of size 128x128 */
+    /* - process as many as possible in super blocks of 2 */
+    size_t num_super_blocks = N / 2;
+    for (size_t superblock_i = 0; superblock_i < num_super_blocks; ++superblock_i) {
+        /* transpose 2 128x128 blocks */
+        u64x4 vec[2][64];
+        memcpy(vec, &src[4096 * superblock_i], 2 * 2048);
+        transpose_bit_128x128_vec(vec[0], vec[0]);
+        transpose_bit_128x128_vec(vec[1], vec[1]);
+        /* store 2 words into each row, one row per vector */
+        for (size_t j = 0; j < 64; ++j) {
+            /* interleave the 128 bit words of the two blocks */
+            u64x4 row_0 = SHUFFLE(u64x4, vec[0][j], vec[1][j], 0, 1, 4, 5);
+            u64x4 row_1 = SHUFFLE(u64x4, vec[0][j], vec[1][j], 2, 3, 6, 7);
+            memcpy(dst[2 * j] + 32 * superblock_i, &row_0, 32);
+            memcpy(dst[2 * j + 1] + 32 * superblock_i, &row_1, 32);
+        }
+    }
+    /* process the remaining 128x128 block */
+    if (N % 2) {
+        size_t block_i = N - 1;
+        u64x4 vec[64];
+        memcpy(vec, &src[2048 * block_i], 2048);
+        transpose_bit_128x128_vec(vec, vec);
+        for (size_t j = 0; j < 128; ++j) {
+            memcpy(dst[j] + 16 * block_i, (uint8_t*)vec + 16 * j, 16);
+        }
+    }
+}
+
+/* the vector extensions offer no portable streaming stores, so the _nt variants
+ * use regular ones */
+
+void transpose_bit_64xN_nt(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_128xN_nt(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_nt(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
+}
+
+/* the functions above stage the blocks anyway, so the _aligned variants are the
+ * regular ones */
+
+void transpose_bit_8xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_8xN(dst, src, N);
+}
+
+void transpose_bit_Nx8_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx8(dst, src, N);
+}
+
+void transpose_bit_16xN_aligned(uint16_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_16xN(dst, src, N);
+}
+
+void transpose_bit_Nx16_aligned(uint8_t** dst, const uint16_t* src, size_t N) {
+    transpose_bit_Nx16(dst, src, N);
+}
+
+void transpose_bit_32xN_aligned(uint32_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_32xN(dst, src, N);
+}
+
+void transpose_bit_Nx32_aligned(uint8_t** dst, const uint32_t* src, size_t N) {
+    transpose_bit_Nx32(dst, src, N);
+}
+
+void transpose_bit_64xN_aligned(uint64_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_64xN(dst, src, N);
+}
+
+void transpose_bit_Nx64_aligned(uint8_t** dst, const uint64_t* src, size_t N) {
+    transpose_bit_Nx64(dst, src, N);
+}
+
+void transpose_bit_128xN_aligned(uint8_t* dst, const uint8_t* const* src, size_t N) {
+    transpose_bit_128xN(dst, src, N);
+}
+
+void transpose_bit_Nx128_aligned(uint8_t** dst, const uint8_t* src, size_t N) {
+    transpose_bit_Nx128(dst, src, N);
+}
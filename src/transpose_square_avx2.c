@@ -21,13 +21,24 @@
  * SOFTWARE.
  */
 
+#include "bit_transpose_backend.h"
 #include "bit_transpose.h"
+#include "bit_transpose_batch.h"
+#include "bit_transpose_extra_avx2.h"
 
 #include <immintrin.h>
 #include <stddef.h>
 #include <string.h>
 
 __m256i transpose_bit_8x8_packed_x4_direct(__m256i matrix) {
+#ifdef __GFNI__
+    /* reverse the rows of each 8x8 matrix, see transpose_bit_8x8_direct */
+    const __m256i reverse_mask = _mm256_set_epi64x(0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                                   0x08090a0b0c0d0e0f, 0x0001020304050607);
+    const __m256i unit_vectors = _mm256_set1_epi64x(0x8040201008040201);
+    matrix = _mm256_shuffle_epi8(matrix, reverse_mask);
+    return _mm256_gf2p8affine_epi64_epi8(unit_vectors, matrix, 0);
+#else
     const __m256i mask_2x2 = _mm256_set1_epi64x(0x5500550055005500);
     const __m256i mask_4x4 = _mm256_set1_epi64x(0x3333000033330000);
     const __m256i mask_8x8 = _mm256_set1_epi64x(0x0f0f0f0f00000000);
@@ -51,17 +62,27 @@ __m256i transpose_bit_8x8_packed_x4_direct(__m256i matrix) {
     tmp = _mm256_srli_epi64(tmp, shift_8x8);
     matrix ^= tmp;
     return matrix;
+#endif
+}
+
+void transpose_bit_8x8_packed_x4(void* dst, const void* src) {
+    __m256i matrix = _mm256_loadu_si256(src);
+    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
+    _mm256_storeu_si256(dst, matrix);
+}
+
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src) {
+    __m256i matrix = _mm256_load_si256(src);
+    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
+    _mm256_store_si256(dst, matrix);
 }
 
 void transpose_bit_8x8_packed_x4_inplace_aligned(void* input) {
-    __m256i* matrix = input;
-    matrix[0] = transpose_bit_8x8_packed_x4_direct(matrix[0]);
+    transpose_bit_8x8_packed_x4_aligned(input, input);
 }
 
 void transpose_bit_8x8_packed_x4_inplace(void* input) {
-    __m256i matrix = _mm256_loadu_si256(input);
-    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
-    _mm256_storeu_si256(input, matrix);
+    transpose_bit_8x8_packed_x4(input, input);
 }
 
 __m256i transpose_bit_16x16_direct(__m256i matrix) {
@@ -84,31 +105,40 @@ __m256i transpose_bit_16x16_direct(__m256i matrix) {
     return matrix;
 }
 
-void transpose_bit_16x16_inplace(void* input) {
-    __m256i matrix = _mm256_loadu_si256(input);
+void transpose_bit_16x16(void* dst, const void* src) {
+    __m256i matrix = _mm256_loadu_si256(src);
+    matrix = transpose_bit_16x16_direct(matrix);
+    _mm256_storeu_si256(dst, matrix);
+}
+
+void transpose_bit_16x16_aligned(void* dst, const void* src) {
+    __m256i matrix = _mm256_load_si256(src);
     matrix = transpose_bit_16x16_direct(matrix);
-    _mm256_storeu_si256(input, matrix);
+    _mm256_store_si256(dst, matrix);
+}
+
+void transpose_bit_16x16_inplace(void* input) {
+    transpose_bit_16x16(input, input);
 }
 
 void transpose_bit_16x16_inplace_aligned(void* input) {
-    __m256i* matrix = input;
-    matrix[0] = transpose_bit_16x16_direct(matrix[0]);
+    transpose_bit_16x16_aligned(input, input);
 }
 
-void transpose_bit_32x32_inplace_aligned(void* input) {
+/* Transpose the 32x32 matrix at src and write the result to dst which may be
+ * equal to src.  Neither needs to be aligned. */
+static inline void transpose_bit_32x32_ymm(void* dst, const void* src) {
     const __m256i shuffle_mask = _mm256_set_epi64x(0x0f0e0b0a07060302, 0x0d0c090805040100,
                                                    0x0f0e0b0a07060302, 0x0d0c090805040100);
     const __m256i inv_shuffle_mask = _mm256_set_epi64x(0x0f0e07060d0c0504, 0x0b0a030209080100,
                                                        0x0f0e07060d0c0504, 0x0b0a030209080100);
 
-    __m256i* src = input;
-
     /* get 16x16 submatrices */
 
-    __m256i rows_0 = _mm256_shuffle_epi8(src[0], shuffle_mask);
-    __m256i rows_1 = _mm256_shuffle_epi8(src[1], shuffle_mask);
-    __m256i rows_2 = _mm256_shuffle_epi8(src[2], shuffle_mask);
-    __m256i rows_3 = _mm256_shuffle_epi8(src[3], shuffle_mask);
+    __m256i rows_0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src) + 0), shuffle_mask);
+    __m256i rows_1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src) + 1), shuffle_mask);
+    __m256i rows_2 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src) + 2), shuffle_mask);
+    __m256i rows_3 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src) + 3), shuffle_mask);
 
     __m256i submatrix_a = _mm256_unpacklo_epi64(rows_0, rows_1);
     __m256i submatrix_b = _mm256_unpackhi_epi64(rows_0, rows_1);
@@ -141,245 +171,294 @@ void transpose_bit_32x32_inplace_aligned(void* input) {
     rows_2 = _mm256_unpacklo_epi64(submatrix_c, submatrix_d);
     rows_3 = _mm256_unpackhi_epi64(submatrix_c, submatrix_d);
 
-    src[0] = _mm256_shuffle_epi8(rows_0, inv_shuffle_mask);
-    src[1] = _mm256_shuffle_epi8(rows_1, inv_shuffle_mask);
-    src[2] = _mm256_shuffle_epi8(rows_2, inv_shuffle_mask);
-    src[3] = _mm256_shuffle_epi8(rows_3, inv_shuffle_mask);
+    _mm256_storeu_si256((__m256i*)(dst) + 0, _mm256_shuffle_epi8(rows_0, inv_shuffle_mask));
+    _mm256_storeu_si256((__m256i*)(dst) + 1, _mm256_shuffle_epi8(rows_1, inv_shuffle_mask));
+    _mm256_storeu_si256((__m256i*)(dst) + 2, _mm256_shuffle_epi8(rows_2, inv_shuffle_mask));
+    _mm256_storeu_si256((__m256i*)(dst) + 3, _mm256_shuffle_epi8(rows_3, inv_shuffle_mask));
+}
+
+void transpose_bit_32x32(void* dst, const void* src) {
+    transpose_bit_32x32_ymm(dst, src);
+}
+
+void transpose_bit_32x32_aligned(void* dst, const void* src) {
+    transpose_bit_32x32_ymm(dst, src);
 }
 
 void transpose_bit_32x32_inplace(void* input) {
-    __m256i matrix[4];
-    memcpy(matrix, input, 32 * 4);
-    transpose_bit_32x32_inplace_aligned(matrix);
-    memcpy(input, matrix, 32 * 4);
+    transpose_bit_32x32_ymm(input, input);
 }
 
-void transpose_bit_64x64_inplace_aligned(void* input) {
+void transpose_bit_32x32_inplace_aligned(void* input) {
+    transpose_bit_32x32_ymm(input, input);
+}
+
+/* Transpose the 64x64 matrix at src and write the result to dst which may be
+ * equal to src.  Neither needs to be aligned. */
+static inline void transpose_bit_64x64_ymm(void* dst, const void* src) {
     const __m256i permute_mask = _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0);
     const __m256i inv_permute_mask = _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0);
-
-    __m256i* src = input;
+    const __m256i* src_p = src;
+    __m256i* dst_p = dst;
     __m256i tmp[16];
-    __m128i* src_as_128i = (__m128i*)(src);
-    __m128i* tmp_as_128i = (__m128i*)(tmp);
 
     /* get 32x32 submatrices */
     /* and swap antidiagonal ones */
-    src[0] = _mm256_permutevar8x32_epi32(src[0], permute_mask);
-    src[1] = _mm256_permutevar8x32_epi32(src[1], permute_mask);
-    tmp[0] = _mm256_set_m128i(src_as_128i[2], src_as_128i[0]);
-    tmp[8] = _mm256_set_m128i(src_as_128i[3], src_as_128i[1]);
-
-    src[2] = _mm256_permutevar8x32_epi32(src[2], permute_mask);
-    src[3] = _mm256_permutevar8x32_epi32(src[3], permute_mask);
-    tmp[1] = _mm256_set_m128i(src_as_128i[6], src_as_128i[4]);
-    tmp[9] = _mm256_set_m128i(src_as_128i[7], src_as_128i[5]);
-
-    src[4] = _mm256_permutevar8x32_epi32(src[4], permute_mask);
-    src[5] = _mm256_permutevar8x32_epi32(src[5], permute_mask);
-    tmp[2] = _mm256_set_m128i(src_as_128i[10], src_as_128i[8]);
-    tmp[10] = _mm256_set_m128i(src_as_128i[11], src_as_128i[9]);
-
-    src[6] = _mm256_permutevar8x32_epi32(src[6], permute_mask);
-    src[7] = _mm256_permutevar8x32_epi32(src[7], permute_mask);
-    tmp[3] = _mm256_set_m128i(src_as_128i[14], src_as_128i[12]);
-    tmp[11] = _mm256_set_m128i(src_as_128i[15], src_as_128i[13]);
-
-    src[8] = _mm256_permutevar8x32_epi32(src[8], permute_mask);
-    src[9] = _mm256_permutevar8x32_epi32(src[9], permute_mask);
-    tmp[4] = _mm256_set_m128i(src_as_128i[18], src_as_128i[16]);
-    tmp[12] = _mm256_set_m128i(src_as_128i[19], src_as_128i[17]);
-
-    src[10] = _mm256_permutevar8x32_epi32(src[10], permute_mask);
-    src[11] = _mm256_permutevar8x32_epi32(src[11], permute_mask);
-    tmp[5] = _mm256_set_m128i(src_as_128i[22], src_as_128i[20]);
-    tmp[13] = _mm256_set_m128i(src_as_128i[23], src_as_128i[21]);
-
-    src[12] = _mm256_permutevar8x32_epi32(src[12], permute_mask);
-    src[13] = _mm256_permutevar8x32_epi32(src[13], permute_mask);
-    tmp[6] = _mm256_set_m128i(src_as_128i[26], src_as_128i[24]);
-    tmp[14] = _mm256_set_m128i(src_as_128i[27], src_as_128i[25]);
-
-    src[14] = _mm256_permutevar8x32_epi32(src[14], permute_mask);
-    src[15] = _mm256_permutevar8x32_epi32(src[15], permute_mask);
-    tmp[7] = _mm256_set_m128i(src_as_128i[30], src_as_128i[28]);
-    tmp[15] = _mm256_set_m128i(src_as_128i[31], src_as_128i[29]);
+    for (size_t i = 0; i < 8; ++i) {
+        __m256i rows_0 = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(&src_p[2 * i]), permute_mask);
+        __m256i rows_1 =
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256(&src_p[2 * i + 1]), permute_mask);
+        tmp[i] = _mm256_permute2x128_si256(rows_0, rows_1, 0b00100000);
+        tmp[8 + i] = _mm256_permute2x128_si256(rows_0, rows_1, 0b00110001);
+    }
 
     /* transpose 32x32s */
-    transpose_bit_32x32_inplace_aligned(tmp);
-    transpose_bit_32x32_inplace_aligned(tmp + 4);
-    transpose_bit_32x32_inplace_aligned(tmp + 8);
-    transpose_bit_32x32_inplace_aligned(tmp + 12);
+    transpose_bit_32x32_ymm(tmp, tmp);
+    transpose_bit_32x32_ymm(tmp + 4, tmp + 4);
+    transpose_bit_32x32_ymm(tmp + 8, tmp + 8);
+    transpose_bit_32x32_ymm(tmp + 12, tmp + 12);
+
+    /* write submatrices to the destination */
+    for (size_t i = 0; i < 4; ++i) {
+        __m256i rows_0 = _mm256_permute2x128_si256(tmp[i], tmp[4 + i], 0b00100000);
+        __m256i rows_1 = _mm256_permute2x128_si256(tmp[i], tmp[4 + i], 0b00110001);
+        __m256i rows_2 = _mm256_permute2x128_si256(tmp[8 + i], tmp[12 + i], 0b00100000);
+        __m256i rows_3 = _mm256_permute2x128_si256(tmp[8 + i], tmp[12 + i], 0b00110001);
+        _mm256_storeu_si256(&dst_p[2 * i], _mm256_permutevar8x32_epi32(rows_0, inv_permute_mask));
+        _mm256_storeu_si256(&dst_p[2 * i + 1],
+                            _mm256_permutevar8x32_epi32(rows_1, inv_permute_mask));
+        _mm256_storeu_si256(&dst_p[8 + 2 * i],
+                            _mm256_permutevar8x32_epi32(rows_2, inv_permute_mask));
+        _mm256_storeu_si256(&dst_p[8 + 2 * i + 1],
+                            _mm256_permutevar8x32_epi32(rows_3, inv_permute_mask));
+    }
+}
 
-    /* write submatrices back */
-    src[0] = _mm256_set_m128i(tmp_as_128i[8], tmp_as_128i[0]);
-    src[0] = _mm256_permutevar8x32_epi32(src[0], inv_permute_mask);
-    src[1] = _mm256_set_m128i(tmp_as_128i[9], tmp_as_128i[1]);
-    src[1] = _mm256_permutevar8x32_epi32(src[1], inv_permute_mask);
-    src[2] = _mm256_set_m128i(tmp_as_128i[10], tmp_as_128i[2]);
-    src[2] = _mm256_permutevar8x32_epi32(src[2], inv_permute_mask);
-    src[3] = _mm256_set_m128i(tmp_as_128i[11], tmp_as_128i[3]);
-    src[3] = _mm256_permutevar8x32_epi32(src[3], inv_permute_mask);
-
-    src[4] = _mm256_set_m128i(tmp_as_128i[12], tmp_as_128i[4]);
-    src[4] = _mm256_permutevar8x32_epi32(src[4], inv_permute_mask);
-    src[5] = _mm256_set_m128i(tmp_as_128i[13], tmp_as_128i[5]);
-    src[5] = _mm256_permutevar8x32_epi32(src[5], inv_permute_mask);
-    src[6] = _mm256_set_m128i(tmp_as_128i[14], tmp_as_128i[6]);
-    src[6] = _mm256_permutevar8x32_epi32(src[6], inv_permute_mask);
-    src[7] = _mm256_set_m128i(tmp_as_128i[15], tmp_as_128i[7]);
-    src[7] = _mm256_permutevar8x32_epi32(src[7], inv_permute_mask);
-
-    src[8] = _mm256_set_m128i(tmp_as_128i[24], tmp_as_128i[16]);
-    src[8] = _mm256_permutevar8x32_epi32(src[8], inv_permute_mask);
-    src[9] = _mm256_set_m128i(tmp_as_128i[25], tmp_as_128i[17]);
-    src[9] = _mm256_permutevar8x32_epi32(src[9], inv_permute_mask);
-    src[10] = _mm256_set_m128i(tmp_as_128i[26], tmp_as_128i[18]);
-    src[10] = _mm256_permutevar8x32_epi32(src[10], inv_permute_mask);
-    src[11] = _mm256_set_m128i(tmp_as_128i[27], tmp_as_128i[19]);
-    src[11] = _mm256_permutevar8x32_epi32(src[11], inv_permute_mask);
-
-    src[12] = _mm256_set_m128i(tmp_as_128i[28], tmp_as_128i[20]);
-    src[12] = _mm256_permutevar8x32_epi32(src[12], inv_permute_mask);
-    src[13] = _mm256_set_m128i(tmp_as_128i[29], tmp_as_128i[21]);
-    src[13] = _mm256_permutevar8x32_epi32(src[13], inv_permute_mask);
-    src[14] = _mm256_set_m128i(tmp_as_128i[30], tmp_as_128i[22]);
-    src[14] = _mm256_permutevar8x32_epi32(src[14], inv_permute_mask);
-    src[15] = _mm256_set_m128i(tmp_as_128i[31], tmp_as_128i[23]);
-    src[15] = _mm256_permutevar8x32_epi32(src[15], inv_permute_mask);
+void transpose_bit_64x64(void* dst, const void* src) {
+    transpose_bit_64x64_ymm(dst, src);
+}
+
+void transpose_bit_64x64_aligned(void* dst, const void* src) {
+    transpose_bit_64x64_ymm(dst, src);
 }
 
 void transpose_bit_64x64_inplace(void* input) {
-    __m256i src[16];
-    memcpy(src, input, 16 * 32);
-    transpose_bit_64x64_inplace_aligned(src);
-    memcpy(input, src, 16 * 32);
+    transpose_bit_64x64_ymm(input, input);
 }
 
-void transpose_bit_128x128_inplace_aligned(void* input) {
-    const uint8_t permute_mask_64 = 0b11011000;    /* 0b11'01'10'00 */
-    const uint8_t permute_mask_128_0 = 0b00100000; /* 0b0010'0000 */
-    const uint8_t permute_mask_128_1 = 0b00110001; /* 0b0011'0001 */
-    __m256i* src = input;
-    __m256i tmp[5];
-
-    /* separate the four submatrices and swap antidiagonal ones */
-
-    for (size_t row_block_i = 0; row_block_i < 16; ++row_block_i) {
-        /* swap the middle 64 bit words of each 256 bit word */
-        /* [0 1 2 3] -> [0 2 1 3] */
-        tmp[0] = _mm256_permute4x64_epi64(src[2 * row_block_i + 0], 0b11011000);
-        tmp[1] = _mm256_permute4x64_epi64(src[2 * row_block_i + 1], 0b11011000);
-        tmp[2] = _mm256_permute4x64_epi64(src[2 * row_block_i + 32], 0b11011000);
-        tmp[3] = _mm256_permute4x64_epi64(src[2 * row_block_i + 33], 0b11011000);
-        /* exchange the middle 128 bit lanes of two 256 bit words */
-        /* [0 2 1 3], [4 6 5 7] -> [0 2 4 6], [1 3 5 7] */
-        /* and swap submatrices */
-        src[2 * row_block_i + 0] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00100000);
-        src[2 * row_block_i + 32] = _mm256_permute2x128_si256(tmp[0], tmp[1], 0b00110001);
-        src[2 * row_block_i + 1] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00100000);
-        src[2 * row_block_i + 33] = _mm256_permute2x128_si256(tmp[2], tmp[3], 0b00110001);
+void transpose_bit_64x64_inplace_aligned(void* input) {
+    transpose_bit_64x64_ymm(input, input);
+}
+
+/* Swap the bits of a selected by (mask << shift) with the bits of b selected
+ * by mask.
+ */
+static inline void delta_swap_epi64(__m256i* a, __m256i* b, const int shift,
+                                    const __m256i mask) {
+    __m256i tmp = (_mm256_srli_epi64(*a, shift) ^ *b) & mask;
+    *b ^= tmp;
+    *a ^= _mm256_slli_epi64(tmp, shift);
+}
+
+/* Transpose a 128x128 matrix with the recursive block swap algorithm.  Each
+ * register holds two rows, so the rounds with distance j swap the registers i
+ * and i + j/2 for j >= 2.  The seven rounds are done in two passes over the
+ * matrix, each of which keeps a group of 8 registers in flight:
+ * - the first pass does the rounds j = 64, 32, 16 on the registers i, i + 8, ..., i + 56,
+ * - the second pass does the rounds j = 8, 4, 2, 1 on the registers 8 i, ..., 8 i + 7.
+ * The 64 registers of the matrix do not fit into the 16 ymm registers, so the
+ * first pass writes the whole intermediate matrix to a 2 KiB scratch tile,
+ * which stays in L1, and the second pass reads it back from there.
+ */
+
+static inline void transpose_bit_128x128_first_pass(__m256i* vec) {
+    const __m256i mask_32 = _mm256_set1_epi64x(0x00000000ffffffff);
+    const __m256i mask_16 = _mm256_set1_epi64x(0x0000ffff0000ffff);
+    /* j = 64: exchange the upper 64 bit of the rows in the upper half with the lower 64 bit
+     * of the rows in the lower half */
+    for (size_t k = 0; k < 4; ++k) {
+        __m256i tmp = _mm256_unpacklo_epi64(vec[k], vec[k + 4]);
+        vec[k + 4] = _mm256_unpackhi_epi64(vec[k], vec[k + 4]);
+        vec[k] = tmp;
+    }
+    /* the remaining rounds stay within the 64 bit words */
+    delta_swap_epi64(&vec[0], &vec[2], 32, mask_32);
+    delta_swap_epi64(&vec[1], &vec[3], 32, mask_32);
+    delta_swap_epi64(&vec[4], &vec[6], 32, mask_32);
+    delta_swap_epi64(&vec[5], &vec[7], 32, mask_32);
+    for (size_t k = 0; k < 8; k += 2) {
+        delta_swap_epi64(&vec[k], &vec[k + 1], 16, mask_16);
+    }
+}
+
+static inline void transpose_bit_128x128_second_pass(__m256i* vec) {
+    const __m256i mask_8 = _mm256_set1_epi64x(0x00ff00ff00ff00ff);
+    const __m256i mask_4 = _mm256_set1_epi64x(0x0f0f0f0f0f0f0f0f);
+    const __m256i mask_2 = _mm256_set1_epi64x(0x3333333333333333);
+    /* only the first row of each register */
+    const __m256i mask_1 = _mm256_set_epi64x(0, 0, 0x5555555555555555, 0x5555555555555555);
+    for (size_t k = 0; k < 4; ++k) {
+        delta_swap_epi64(&vec[k], &vec[k + 4], 8, mask_8);
+    }
+    delta_swap_epi64(&vec[0], &vec[2], 4, mask_4);
+    delta_swap_epi64(&vec[1], &vec[3], 4, mask_4);
+    delta_swap_epi64(&vec[4], &vec[6], 4, mask_4);
+    delta_swap_epi64(&vec[5], &vec[7], 4, mask_4);
+    for (size_t k = 0; k < 8; k += 2) {
+        delta_swap_epi64(&vec[k], &vec[k + 1], 2, mask_2);
     }
+    /* j = 1: the two rows of a register are swapped via its 128 bit lanes */
+    for (size_t k = 0; k < 8; ++k) {
+        __m256i swapped = _mm256_permute2x128_si256(vec[k], vec[k], 0x01);
+        __m256i tmp = (_mm256_srli_epi64(vec[k], 1) ^ swapped) & mask_1;
+        vec[k] ^= _mm256_slli_epi64(tmp, 1) ^ _mm256_permute2x128_si256(tmp, tmp, 0x01);
+    }
+}
+
+/* Do the second pass on the result of the first pass and write the transposed
+ * matrix to dst, with streaming stores if stream is set (dst must then be
+ * aligned). */
+static inline void transpose_bit_128x128_finish(void* dst, const __m256i* tile, const int stream) {
+    __m256i* dst_p = dst;
+    __m256i vec[8];
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t k = 0; k < 8; ++k) {
+            vec[k] = tile[8 * i + k];
+        }
+        transpose_bit_128x128_second_pass(vec);
+        for (size_t k = 0; k < 8; ++k) {
+            if (stream) {
+                _mm256_stream_si256(&dst_p[8 * i + k], vec[k]);
+            } else {
+                _mm256_storeu_si256(&dst_p[8 * i + k], vec[k]);
+            }
+        }
+    }
+}
+
+void transpose_bit_128x128(void* dst, const void* src) {
+    /* the first pass leaves the intermediate result in an aligned scratch tile, so
+     * that the source is read and the destination is written exactly once; this
+     * round trip through L1 is the only one left between the two passes */
+    __m256i tile[64];
+    const __m256i* src_p = src;
+    __m256i vec[8];
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t k = 0; k < 8; ++k) {
+            vec[k] = _mm256_loadu_si256(&src_p[i + 8 * k]);
+        }
+        transpose_bit_128x128_first_pass(vec);
+        for (size_t k = 0; k < 8; ++k) {
+            tile[i + 8 * k] = vec[k];
+        }
+    }
+    transpose_bit_128x128_finish(dst, tile, 0);
+}
 
-    /* the neighbouring submatrices are now interleaved as 256 bit words each */
-
-    /* clang-format off */
-
-    /* move the elements to the right position in 5er cycles */
-    /* upper half: */
-    tmp[0] = src[1]; tmp[1] = src[16]; tmp[2] = src[8]; tmp[3] = src[4]; tmp[4] = src[2];
-    src[16] = tmp[0]; src[8] = tmp[1]; src[4] = tmp[2]; src[2] = tmp[3]; src[1] = tmp[4];
-    tmp[0] = src[3]; tmp[1] = src[17]; tmp[2] = src[24]; tmp[3] = src[12]; tmp[4] = src[6];
-    src[17] = tmp[0]; src[24] = tmp[1]; src[12] = tmp[2]; src[6] = tmp[3]; src[3] = tmp[4];
-    tmp[0] = src[5]; tmp[1] = src[18]; tmp[2] = src[9]; tmp[3] = src[20]; tmp[4] = src[10];
-    src[18] = tmp[0]; src[9] = tmp[1]; src[20] = tmp[2]; src[10] = tmp[3]; src[5] = tmp[4];
-    tmp[0] = src[7]; tmp[1] = src[19]; tmp[2] = src[25]; tmp[3] = src[28]; tmp[4] = src[14];
-    src[19] = tmp[0]; src[25] = tmp[1]; src[28] = tmp[2]; src[14] = tmp[3]; src[7] = tmp[4];
-    tmp[0] = src[11]; tmp[1] = src[21]; tmp[2] = src[26]; tmp[3] = src[13]; tmp[4] = src[22];
-    src[21] = tmp[0]; src[26] = tmp[1]; src[13] = tmp[2]; src[22] = tmp[3]; src[11] = tmp[4];
-    tmp[0] = src[15]; tmp[1] = src[23]; tmp[2] = src[27]; tmp[3] = src[29]; tmp[4] = src[30];
-    src[23] = tmp[0]; src[27] = tmp[1]; src[29] = tmp[2]; src[30] = tmp[3]; src[15] = tmp[4];
-    /* lower half */
-    tmp[0] = src[33]; tmp[1] = src[48]; tmp[2] = src[40]; tmp[3] = src[36]; tmp[4] = src[34];
-    src[48] = tmp[0]; src[40] = tmp[1]; src[36] = tmp[2]; src[34] = tmp[3]; src[33] = tmp[4];
-    tmp[0] = src[35]; tmp[1] = src[49]; tmp[2] = src[56]; tmp[3] = src[44]; tmp[4] = src[38];
-    src[49] = tmp[0]; src[56] = tmp[1]; src[44] = tmp[2]; src[38] = tmp[3]; src[35] = tmp[4];
-    tmp[0] = src[37]; tmp[1] = src[50]; tmp[2] = src[41]; tmp[3] = src[52]; tmp[4] = src[42];
-    src[50] = tmp[0]; src[41] = tmp[1]; src[52] = tmp[2]; src[42] = tmp[3]; src[37] = tmp[4];
-    tmp[0] = src[39]; tmp[1] = src[51]; tmp[2] = src[57]; tmp[3] = src[60]; tmp[4] = src[46];
-    src[51] = tmp[0]; src[57] = tmp[1]; src[60] = tmp[2]; src[46] = tmp[3]; src[39] = tmp[4];
-    tmp[0] = src[43]; tmp[1] = src[53]; tmp[2] = src[58]; tmp[3] = src[45]; tmp[4] = src[54];
-    src[53] = tmp[0]; src[58] = tmp[1]; src[45] = tmp[2]; src[54] = tmp[3]; src[43] = tmp[4];
-    tmp[0] = src[47]; tmp[1] = src[55]; tmp[2] = src[59]; tmp[3] = src[61]; tmp[4] = src[62];
-    src[55] = tmp[0]; src[59] = tmp[1]; src[61] = tmp[2]; src[62] = tmp[3]; src[47] = tmp[4];
-
-    /* clang-format on */
-
-    /* transpose each submatrix */
-    transpose_bit_64x64_inplace_aligned(src);
-    transpose_bit_64x64_inplace_aligned(src + 16);
-    transpose_bit_64x64_inplace_aligned(src + 32);
-    transpose_bit_64x64_inplace_aligned(src + 48);
-
-    /* interleave the neighbouring submatrices again */
-
-    /* clang-format off */
-
-    /* interleave them as 256 bit words each in 5er cycles */
-    /* upper half: */
-    tmp[0] = src[1]; tmp[1] = src[16]; tmp[2] = src[8]; tmp[3] = src[4]; tmp[4] = src[2];
-    src[2] = tmp[0]; src[1] = tmp[1]; src[16] = tmp[2]; src[8] = tmp[3]; src[4] = tmp[4];
-    tmp[0] = src[3]; tmp[1] = src[17]; tmp[2] = src[24]; tmp[3] = src[12]; tmp[4] = src[6];
-    src[6] = tmp[0]; src[3] = tmp[1]; src[17] = tmp[2]; src[24] = tmp[3]; src[12] = tmp[4];
-    tmp[0] = src[5]; tmp[1] = src[18]; tmp[2] = src[9]; tmp[3] = src[20]; tmp[4] = src[10];
-    src[10] = tmp[0]; src[5] = tmp[1]; src[18] = tmp[2]; src[9] = tmp[3]; src[20] = tmp[4];
-    tmp[0] = src[7]; tmp[1] = src[19]; tmp[2] = src[25]; tmp[3] = src[28]; tmp[4] = src[14];
-    src[14] = tmp[0]; src[7] = tmp[1]; src[19] = tmp[2]; src[25] = tmp[3]; src[28] = tmp[4];
-    tmp[0] = src[11]; tmp[1] = src[21]; tmp[2] = src[26]; tmp[3] = src[13]; tmp[4] = src[22];
-    src[22] = tmp[0]; src[11] = tmp[1]; src[21] = tmp[2]; src[26] = tmp[3]; src[13] = tmp[4];
-    tmp[0] = src[15]; tmp[1] = src[23]; tmp[2] = src[27]; tmp[3] = src[29]; tmp[4] = src[30];
-    src[30] = tmp[0]; src[15] = tmp[1]; src[23] = tmp[2]; src[27] = tmp[3]; src[29] = tmp[4];
-    /* lower half: */
-    tmp[0] = src[33]; tmp[1] = src[48]; tmp[2] = src[40]; tmp[3] = src[36]; tmp[4] = src[34];
-    src[34] = tmp[0]; src[33] = tmp[1]; src[48] = tmp[2]; src[40] = tmp[3]; src[36] = tmp[4];
-    tmp[0] = src[35]; tmp[1] = src[49]; tmp[2] = src[56]; tmp[3] = src[44]; tmp[4] = src[38];
-    src[38] = tmp[0]; src[35] = tmp[1]; src[49] = tmp[2]; src[56] = tmp[3]; src[44] = tmp[4];
-    tmp[0] = src[37]; tmp[1] = src[50]; tmp[2] = src[41]; tmp[3] = src[52]; tmp[4] = src[42];
-    src[42] = tmp[0]; src[37] = tmp[1]; src[50] = tmp[2]; src[41] = tmp[3]; src[52] = tmp[4];
-    tmp[0] = src[39]; tmp[1] = src[51]; tmp[2] = src[57]; tmp[3] = src[60]; tmp[4] = src[46];
-    src[46] = tmp[0]; src[39] = tmp[1]; src[51] = tmp[2]; src[57] = tmp[3]; src[60] = tmp[4];
-    tmp[0] = src[43]; tmp[1] = src[53]; tmp[2] = src[58]; tmp[3] = src[45]; tmp[4] = src[54];
-    src[54] = tmp[0]; src[43] = tmp[1]; src[53] = tmp[2]; src[58] = tmp[3]; src[45] = tmp[4];
-    tmp[0] = src[47]; tmp[1] = src[55]; tmp[2] = src[59]; tmp[3] = src[61]; tmp[4] = src[62];
-    src[62] = tmp[0]; src[47] = tmp[1]; src[55] = tmp[2]; src[59] = tmp[3]; src[61] = tmp[4];
-
-    /* clang-format on */
-
-    /* the neighbouring submatrices are now interleaved as 256 bit words each */
-
-    for (size_t row_block_i = 0; row_block_i < 16; ++row_block_i) {
-        /* exchange the middle 128 bit lanes of two 256 bit words */
-        /* [0 2 4 6], [1 3 5 7] -> [0 2 1 3], [4 6 5 7] */
-        tmp[0] = _mm256_permute2x128_si256(src[4 * row_block_i + 0], src[4 * row_block_i + 1],
-                                           0b00100000);
-        tmp[1] = _mm256_permute2x128_si256(src[4 * row_block_i + 0], src[4 * row_block_i + 1],
-                                           0b00110001);
-        tmp[2] = _mm256_permute2x128_si256(src[4 * row_block_i + 2], src[4 * row_block_i + 3],
-                                           0b00100000);
-        tmp[3] = _mm256_permute2x128_si256(src[4 * row_block_i + 2], src[4 * row_block_i + 3],
-                                           0b00110001);
-        /* swap the middle 64 bit words of each 256 bit word */
-        /* [0 2 1 3] -> [0 1 2 3] */
-        src[4 * row_block_i + 0] = _mm256_permute4x64_epi64(tmp[0], 0b11011000);
-        src[4 * row_block_i + 1] = _mm256_permute4x64_epi64(tmp[1], 0b11011000);
-        src[4 * row_block_i + 2] = _mm256_permute4x64_epi64(tmp[2], 0b11011000);
-        src[4 * row_block_i + 3] = _mm256_permute4x64_epi64(tmp[3], 0b11011000);
+static inline void transpose_bit_128x128_gather_impl(void* dst, const uint8_t* const* src,
+                                                     size_t offset, const int stream) {
+    /* as above, but the first pass loads the rows directly */
+    __m256i tile[64];
+    __m256i vec[8];
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t k = 0; k < 8; ++k) {
+            const size_t row = 2 * (i + 8 * k);
+            vec[k] = _mm256_set_m128i(_mm_loadu_si128((const __m128i*)(src[row + 1] + offset)),
+                                      _mm_loadu_si128((const __m128i*)(src[row] + offset)));
+        }
+        transpose_bit_128x128_first_pass(vec);
+        for (size_t k = 0; k < 8; ++k) {
+            tile[i + 8 * k] = vec[k];
+        }
     }
+    transpose_bit_128x128_finish(dst, tile, stream);
+}
+
+void transpose_bit_128x128_gather(void* dst, const uint8_t* const* src, size_t offset) {
+    transpose_bit_128x128_gather_impl(dst, src, offset, 0);
+}
+
+void transpose_bit_128x128_gather_stream(void* dst, const uint8_t* const* src, size_t offset) {
+    transpose_bit_128x128_gather_impl(dst, src, offset, 1);
+}
+
+void transpose_bit_128x128_aligned(void* dst, const void* src) {
+    transpose_bit_128x128(dst, src);
+}
+
+void transpose_bit_128x128_inplace_aligned(void* input) {
+    transpose_bit_128x128(input, input);
 }
 
 void transpose_bit_128x128_inplace(void* input) {
-    __m256i src[64];
-    memcpy(src, input, 64 * 32);
-    transpose_bit_128x128_inplace_aligned(src);
-    memcpy(input, src, 64 * 32);
+    transpose_bit_128x128(input, input);
+}
+
+/* The 16x16 batch keeps two matrices in registers per iteration, the others
+ * call the single-matrix kernels in a loop with prefetching. */
+
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count) {
+    const __m256i* src_p = src;
+    __m256i* dst_p = dst;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        prefetch_batch(src, 32 * i, 64, 32 * count);
+        __m256i matrix_0 = _mm256_loadu_si256(&src_p[i]);
+        __m256i matrix_1 = _mm256_loadu_si256(&src_p[i + 1]);
+        matrix_0 = transpose_bit_16x16_direct(matrix_0);
+        matrix_1 = transpose_bit_16x16_direct(matrix_1);
+        _mm256_storeu_si256(&dst_p[i], matrix_0);
+        _mm256_storeu_si256(&dst_p[i + 1], matrix_1);
+    }
+    if (i < count) {
+        transpose_bit_16x16(&dst_p[i], &src_p[i]);
+    }
+}
+
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_16x16_batch(matrices, matrices, count);
+}
+
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count) {
+    const __m256i* src_p = src;
+    __m256i* dst_p = dst;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        prefetch_batch(src, 128 * i, 256, 128 * count);
+        transpose_bit_32x32_ymm(&dst_p[4 * i], &src_p[4 * i]);
+        transpose_bit_32x32_ymm(&dst_p[4 * i + 4], &src_p[4 * i + 4]);
+    }
+    if (i < count) {
+        transpose_bit_32x32_ymm(&dst_p[4 * i], &src_p[4 * i]);
+    }
+}
+
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_32x32_batch(matrices, matrices, count);
+}
+
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 512 * i, 512, 512 * count);
+        transpose_bit_64x64_ymm(dst_bytes + 512 * i, src_bytes + 512 * i);
+    }
+}
+
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_64x64_batch(matrices, matrices, count);
+}
+
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+        transpose_bit_128x128(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+    }
+}
+
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_128x128_batch(matrices, matrices, count);
 }
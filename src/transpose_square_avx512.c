@@ -0,0 +1,474 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_batch.h"
+#include "bit_transpose_extra_avx512.h"
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <string.h>
+
+/* The masked delta swaps below are expressed with vpternlog:
+ * - 0x28 computes (a ^ b) & c
+ * - 0x96 computes a ^ b ^ c
+ */
+
+__m256i transpose_bit_8x8_packed_x4_direct(__m256i matrix) {
+#ifdef __GFNI__
+    /* reverse the rows of each 8x8 matrix, see transpose_bit_8x8_direct */
+    const __m256i reverse_mask = _mm256_set_epi64x(0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                                   0x08090a0b0c0d0e0f, 0x0001020304050607);
+    const __m256i unit_vectors = _mm256_set1_epi64x(0x8040201008040201);
+    matrix = _mm256_shuffle_epi8(matrix, reverse_mask);
+    return _mm256_gf2p8affine_epi64_epi8(unit_vectors, matrix, 0);
+#else
+    const __m256i mask_2x2 = _mm256_set1_epi64x(0x5500550055005500);
+    const __m256i mask_4x4 = _mm256_set1_epi64x(0x3333000033330000);
+    const __m256i mask_8x8 = _mm256_set1_epi64x(0x0f0f0f0f00000000);
+    const size_t shift_2x2 = 7;
+    const size_t shift_4x4 = 14;
+    const size_t shift_8x8 = 28;
+    __m256i tmp;
+
+    tmp = _mm256_ternarylogic_epi64(matrix, _mm256_slli_epi64(matrix, shift_2x2), mask_2x2, 0x28);
+    matrix = _mm256_ternarylogic_epi64(matrix, tmp, _mm256_srli_epi64(tmp, shift_2x2), 0x96);
+
+    tmp = _mm256_ternarylogic_epi64(matrix, _mm256_slli_epi64(matrix, shift_4x4), mask_4x4, 0x28);
+    matrix = _mm256_ternarylogic_epi64(matrix, tmp, _mm256_srli_epi64(tmp, shift_4x4), 0x96);
+
+    tmp = _mm256_ternarylogic_epi64(matrix, _mm256_slli_epi64(matrix, shift_8x8), mask_8x8, 0x28);
+    matrix = _mm256_ternarylogic_epi64(matrix, tmp, _mm256_srli_epi64(tmp, shift_8x8), 0x96);
+    return matrix;
+#endif
+}
+
+__m512i transpose_bit_8x8_packed_x8_direct(__m512i matrix) {
+#ifdef __GFNI__
+    /* reverse the rows of each 8x8 matrix, see transpose_bit_8x8_direct */
+    const __m512i reverse_mask = _mm512_set_epi64(
+        0x08090a0b0c0d0e0f, 0x0001020304050607, 0x08090a0b0c0d0e0f, 0x0001020304050607,
+        0x08090a0b0c0d0e0f, 0x0001020304050607, 0x08090a0b0c0d0e0f, 0x0001020304050607);
+    const __m512i unit_vectors = _mm512_set1_epi64(0x8040201008040201);
+    matrix = _mm512_shuffle_epi8(matrix, reverse_mask);
+    return _mm512_gf2p8affine_epi64_epi8(unit_vectors, matrix, 0);
+#else
+    const __m512i mask_2x2 = _mm512_set1_epi64(0x5500550055005500);
+    const __m512i mask_4x4 = _mm512_set1_epi64(0x3333000033330000);
+    const __m512i mask_8x8 = _mm512_set1_epi64(0x0f0f0f0f00000000);
+    const unsigned int shift_2x2 = 7;
+    const unsigned int shift_4x4 = 14;
+    const unsigned int shift_8x8 = 28;
+    __m512i tmp;
+
+    tmp = _mm512_ternarylogic_epi64(matrix, _mm512_slli_epi64(matrix, shift_2x2), mask_2x2, 0x28);
+    matrix = _mm512_ternarylogic_epi64(matrix, tmp, _mm512_srli_epi64(tmp, shift_2x2), 0x96);
+
+    tmp = _mm512_ternarylogic_epi64(matrix, _mm512_slli_epi64(matrix, shift_4x4), mask_4x4, 0x28);
+    matrix = _mm512_ternarylogic_epi64(matrix, tmp, _mm512_srli_epi64(tmp, shift_4x4), 0x96);
+
+    tmp = _mm512_ternarylogic_epi64(matrix, _mm512_slli_epi64(matrix, shift_8x8), mask_8x8, 0x28);
+    matrix = _mm512_ternarylogic_epi64(matrix, tmp, _mm512_srli_epi64(tmp, shift_8x8), 0x96);
+    return matrix;
+#endif
+}
+
+void transpose_bit_8x8_packed_x4(void* dst, const void* src) {
+    __m256i matrix = _mm256_loadu_si256(src);
+    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
+    _mm256_storeu_si256(dst, matrix);
+}
+
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src) {
+    __m256i matrix = _mm256_load_si256(src);
+    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
+    _mm256_store_si256(dst, matrix);
+}
+
+void transpose_bit_8x8_packed_x4_inplace_aligned(void* input) {
+    transpose_bit_8x8_packed_x4_aligned(input, input);
+}
+
+void transpose_bit_8x8_packed_x4_inplace(void* input) {
+    transpose_bit_8x8_packed_x4(input, input);
+}
+
+__m256i transpose_bit_16x16_direct(__m256i matrix) {
+    /* in-line byte shuffle */
+    const __m256i shuffle_mask_1 = _mm256_set_epi64x(0x0f0d0b0907050301, 0x0e0c0a0806040200,
+                                                     0x0f0d0b0907050301, 0x0e0c0a0806040200);
+    matrix = _mm256_shuffle_epi8(matrix, shuffle_mask_1);
+
+    /* transpose packed 8x8 */
+    matrix = transpose_bit_8x8_packed_x4_direct(matrix);
+
+    /* cross-lane byte shuffle */
+    matrix = _mm256_permute4x64_epi64(matrix, 0b11011000);
+
+    /* in-line byte shuffle */
+    const __m256i shuffle_mask_2 = _mm256_set_epi64x(0x0f070e060d050c04, 0x0b030a0209010800,
+                                                     0x0f070e060d050c04, 0x0b030a0209010800);
+    matrix = _mm256_shuffle_epi8(matrix, shuffle_mask_2);
+
+    return matrix;
+}
+
+__m512i transpose_bit_16x16_packed_x2_direct(__m512i matrix) {
+    /* same as transpose_bit_16x16_direct on both 256 bit halves */
+
+    /* in-line byte shuffle */
+    const __m512i shuffle_mask_1 = _mm512_set_epi64(
+        0x0f0d0b0907050301, 0x0e0c0a0806040200, 0x0f0d0b0907050301, 0x0e0c0a0806040200,
+        0x0f0d0b0907050301, 0x0e0c0a0806040200, 0x0f0d0b0907050301, 0x0e0c0a0806040200);
+    matrix = _mm512_shuffle_epi8(matrix, shuffle_mask_1);
+
+    /* transpose packed 8x8 */
+    matrix = transpose_bit_8x8_packed_x8_direct(matrix);
+
+    /* byte shuffle across the 128 bit lanes of each 256 bit half */
+    matrix = _mm512_permutex_epi64(matrix, 0b11011000);
+
+    /* in-line byte shuffle */
+    const __m512i shuffle_mask_2 = _mm512_set_epi64(
+        0x0f070e060d050c04, 0x0b030a0209010800, 0x0f070e060d050c04, 0x0b030a0209010800,
+        0x0f070e060d050c04, 0x0b030a0209010800, 0x0f070e060d050c04, 0x0b030a0209010800);
+    matrix = _mm512_shuffle_epi8(matrix, shuffle_mask_2);
+
+    return matrix;
+}
+
+void transpose_bit_16x16(void* dst, const void* src) {
+    __m256i matrix = _mm256_loadu_si256(src);
+    matrix = transpose_bit_16x16_direct(matrix);
+    _mm256_storeu_si256(dst, matrix);
+}
+
+void transpose_bit_16x16_aligned(void* dst, const void* src) {
+    __m256i matrix = _mm256_load_si256(src);
+    matrix = transpose_bit_16x16_direct(matrix);
+    _mm256_store_si256(dst, matrix);
+}
+
+void transpose_bit_16x16_inplace(void* input) {
+    transpose_bit_16x16(input, input);
+}
+
+void transpose_bit_16x16_inplace_aligned(void* input) {
+    transpose_bit_16x16_aligned(input, input);
+}
+
+/* The larger matrices are transposed with the recursive block swap: In the
+ * round with distance j, the j-bit wide blocks of row k with k & j == 0 are
+ * exchanged with the ones of row k + j.  If the two rows are stored in
+ * different registers, this is a masked delta swap between them.  Otherwise,
+ * the rows of a pair of registers are first separated with vpermt2d/vpermt2q
+ * such that the rows to be swapped end up in the same lanes.
+ *
+ * The loops of the form `i = ((i | d) + 1) & ~d` iterate over all register
+ * indices i with i & d == 0. */
+
+static inline void delta_swap_epi32(__m512i* a, __m512i* b, const unsigned int shift,
+                                    const __m512i mask) {
+    __m512i tmp = _mm512_ternarylogic_epi32(_mm512_srli_epi32(*a, shift), *b, mask, 0x28);
+    *b = _mm512_xor_si512(*b, tmp);
+    *a = _mm512_xor_si512(*a, _mm512_slli_epi32(tmp, shift));
+}
+
+static inline void delta_swap_epi64(__m512i* a, __m512i* b, const unsigned int shift,
+                                    const __m512i mask) {
+    __m512i tmp = _mm512_ternarylogic_epi64(_mm512_srli_epi64(*a, shift), *b, mask, 0x28);
+    *b = _mm512_xor_si512(*b, tmp);
+    *a = _mm512_xor_si512(*a, _mm512_slli_epi64(tmp, shift));
+}
+
+void transpose_bit_32x32_zmm(__m512i* matrix) {
+    /* matrix[0] contains rows 0-15, matrix[1] rows 16-31 */
+
+    /* swap blocks of 16 rows */
+    delta_swap_epi32(&matrix[0], &matrix[1], 16, _mm512_set1_epi32(0x0000ffff));
+
+    /* swap blocks of 8, 4, 2, 1 rows which share a register */
+    permute_pair_epi32(&matrix[0], &matrix[1],
+                       _mm512_set_epi32(23, 22, 21, 20, 19, 18, 17, 16, 7, 6, 5, 4, 3, 2, 1, 0),
+                       _mm512_set_epi32(31, 30, 29, 28, 27, 26, 25, 24, 15, 14, 13, 12, 11, 10,
+                                        9, 8));
+    delta_swap_epi32(&matrix[0], &matrix[1], 8, _mm512_set1_epi32(0x00ff00ff));
+    permute_pair_epi32(&matrix[0], &matrix[1],
+                       _mm512_set_epi32(27, 26, 25, 24, 11, 10, 9, 8, 19, 18, 17, 16, 3, 2, 1, 0),
+                       _mm512_set_epi32(31, 30, 29, 28, 15, 14, 13, 12, 23, 22, 21, 20, 7, 6, 5,
+                                        4));
+    delta_swap_epi32(&matrix[0], &matrix[1], 4, _mm512_set1_epi32(0x0f0f0f0f));
+    permute_pair_epi32(&matrix[0], &matrix[1],
+                       _mm512_set_epi32(29, 28, 13, 12, 25, 24, 9, 8, 21, 20, 5, 4, 17, 16, 1, 0),
+                       _mm512_set_epi32(31, 30, 15, 14, 27, 26, 11, 10, 23, 22, 7, 6, 19, 18, 3,
+                                        2));
+    delta_swap_epi32(&matrix[0], &matrix[1], 2, _mm512_set1_epi32(0x33333333));
+    permute_pair_epi32(&matrix[0], &matrix[1],
+                       _mm512_set_epi32(30, 14, 28, 12, 26, 10, 24, 8, 22, 6, 20, 4, 18, 2, 16, 0),
+                       _mm512_set_epi32(31, 15, 29, 13, 27, 11, 25, 9, 23, 7, 21, 5, 19, 3, 17,
+                                        1));
+    delta_swap_epi32(&matrix[0], &matrix[1], 1, _mm512_set1_epi32(0x55555555));
+
+    /* restore the original order of the rows */
+    permute_pair_epi32(&matrix[0], &matrix[1],
+                       _mm512_set_epi32(23, 7, 22, 6, 21, 5, 20, 4, 19, 3, 18, 2, 17, 1, 16, 0),
+                       _mm512_set_epi32(31, 15, 30, 14, 29, 13, 28, 12, 27, 11, 26, 10, 25, 9,
+                                        24, 8));
+}
+
+void transpose_bit_32x32(void* dst, const void* src) {
+    __m512i matrix[2];
+    matrix[0] = _mm512_loadu_si512(src);
+    matrix[1] = _mm512_loadu_si512((const uint8_t*)(src) + 64);
+    transpose_bit_32x32_zmm(matrix);
+    _mm512_storeu_si512(dst, matrix[0]);
+    _mm512_storeu_si512((uint8_t*)(dst) + 64, matrix[1]);
+}
+
+void transpose_bit_32x32_aligned(void* dst, const void* src) {
+    /* only 32 byte alignment is guaranteed */
+    transpose_bit_32x32(dst, src);
+}
+
+void transpose_bit_32x32_inplace(void* input) {
+    transpose_bit_32x32(input, input);
+}
+
+void transpose_bit_32x32_inplace_aligned(void* input) {
+    transpose_bit_32x32(input, input);
+}
+
+void transpose_bit_64x64_zmm(__m512i* matrix) {
+    /* matrix[i] contains rows 8i to 8i+7 */
+
+    /* swap blocks of 32, 16, 8 rows */
+    const __m512i mask_32 = _mm512_set1_epi64(0x00000000ffffffff);
+    const __m512i mask_16 = _mm512_set1_epi64(0x0000ffff0000ffff);
+    const __m512i mask_8 = _mm512_set1_epi64(0x00ff00ff00ff00ff);
+    for (size_t i = 0; i < 4; ++i) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 4], 32, mask_32);
+    }
+    for (size_t i = 0; i < 8; i = ((i | 2) + 1) & ~2) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 2], 16, mask_16);
+    }
+    for (size_t i = 0; i < 8; i += 2) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 8, mask_8);
+    }
+
+    /* swap blocks of 4, 2, 1 rows which share a register */
+    const __m512i mask_4 = _mm512_set1_epi64(0x0f0f0f0f0f0f0f0f);
+    const __m512i mask_2 = _mm512_set1_epi64(0x3333333333333333);
+    const __m512i mask_1 = _mm512_set1_epi64(0x5555555555555555);
+    const __m512i index_4_a = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+    const __m512i index_4_b = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+    const __m512i index_2_a = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+    const __m512i index_2_b = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+    const __m512i index_1_a = _mm512_set_epi64(14, 6, 12, 4, 10, 2, 8, 0);
+    const __m512i index_1_b = _mm512_set_epi64(15, 7, 13, 5, 11, 3, 9, 1);
+    const __m512i index_restore_a = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+    const __m512i index_restore_b = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+    for (size_t i = 0; i < 8; i += 2) {
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_4_a, index_4_b);
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 4, mask_4);
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_2_a, index_2_b);
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 2, mask_2);
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_1_a, index_1_b);
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 1, mask_1);
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_restore_a, index_restore_b);
+    }
+}
+
+void transpose_bit_64x64(void* dst, const void* src) {
+    __m512i matrix[8];
+    for (size_t i = 0; i < 8; ++i) {
+        matrix[i] = _mm512_loadu_si512((const uint8_t*)(src) + 64 * i);
+    }
+    transpose_bit_64x64_zmm(matrix);
+    for (size_t i = 0; i < 8; ++i) {
+        _mm512_storeu_si512((uint8_t*)(dst) + 64 * i, matrix[i]);
+    }
+}
+
+void transpose_bit_64x64_aligned(void* dst, const void* src) {
+    /* only 32 byte alignment is guaranteed */
+    transpose_bit_64x64(dst, src);
+}
+
+void transpose_bit_64x64_inplace(void* input) {
+    transpose_bit_64x64(input, input);
+}
+
+void transpose_bit_64x64_inplace_aligned(void* input) {
+    transpose_bit_64x64(input, input);
+}
+
+void transpose_bit_128x128_zmm(__m512i* matrix) {
+    /* matrix[i] contains rows 4i to 4i+3, each as two 64 bit words */
+
+    /* swap the upper right and the lower left 64x64 submatrices */
+    const __m512i index_64_a = _mm512_set_epi64(14, 6, 12, 4, 10, 2, 8, 0);
+    const __m512i index_64_b = _mm512_set_epi64(15, 7, 13, 5, 11, 3, 9, 1);
+    for (size_t i = 0; i < 16; ++i) {
+        permute_pair_epi64(&matrix[i], &matrix[i + 16], index_64_a, index_64_b);
+    }
+
+    /* now the low and high 64 bit words of the rows form four independent
+     * 64x64 submatrices which are transposed simultaneously */
+
+    /* swap blocks of 32, 16, 8, 4 rows */
+    const __m512i mask_32 = _mm512_set1_epi64(0x00000000ffffffff);
+    const __m512i mask_16 = _mm512_set1_epi64(0x0000ffff0000ffff);
+    const __m512i mask_8 = _mm512_set1_epi64(0x00ff00ff00ff00ff);
+    const __m512i mask_4 = _mm512_set1_epi64(0x0f0f0f0f0f0f0f0f);
+    for (size_t i = 0; i < 32; i = ((i | 8) + 1) & ~8) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 8], 32, mask_32);
+    }
+    for (size_t i = 0; i < 32; i = ((i | 4) + 1) & ~4) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 4], 16, mask_16);
+    }
+    for (size_t i = 0; i < 32; i = ((i | 2) + 1) & ~2) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 2], 8, mask_8);
+    }
+    for (size_t i = 0; i < 32; i += 2) {
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 4, mask_4);
+    }
+
+    /* swap blocks of 2, 1 rows which share a register */
+    const __m512i mask_2 = _mm512_set1_epi64(0x3333333333333333);
+    const __m512i mask_1 = _mm512_set1_epi64(0x5555555555555555);
+    const __m512i index_2_a = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+    const __m512i index_2_b = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+    const __m512i index_1_a = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+    const __m512i index_1_b = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+    const __m512i index_restore_a = _mm512_set_epi64(11, 10, 3, 2, 9, 8, 1, 0);
+    const __m512i index_restore_b = _mm512_set_epi64(15, 14, 7, 6, 13, 12, 5, 4);
+    for (size_t i = 0; i < 32; i += 2) {
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_2_a, index_2_b);
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 2, mask_2);
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_1_a, index_1_b);
+        delta_swap_epi64(&matrix[i], &matrix[i + 1], 1, mask_1);
+        permute_pair_epi64(&matrix[i], &matrix[i + 1], index_restore_a, index_restore_b);
+    }
+}
+
+void transpose_bit_128x128(void* dst, const void* src) {
+    __m512i matrix[32];
+    for (size_t i = 0; i < 32; ++i) {
+        matrix[i] = _mm512_loadu_si512((const uint8_t*)(src) + 64 * i);
+    }
+    transpose_bit_128x128_zmm(matrix);
+    for (size_t i = 0; i < 32; ++i) {
+        _mm512_storeu_si512((uint8_t*)(dst) + 64 * i, matrix[i]);
+    }
+}
+
+void transpose_bit_128x128_aligned(void* dst, const void* src) {
+    /* only 32 byte alignment is guaranteed */
+    transpose_bit_128x128(dst, src);
+}
+
+void transpose_bit_128x128_inplace(void* input) {
+    transpose_bit_128x128(input, input);
+}
+
+void transpose_bit_128x128_inplace_aligned(void* input) {
+    transpose_bit_128x128(input, input);
+}
+
+/* The batch functions transpose two of the smaller matrices per iteration, so
+ * that their dependency chains can overlap. */
+
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    size_t i = 0;
+    /* both matrices share a register */
+    for (; i + 2 <= count; i += 2) {
+        prefetch_batch(src, 32 * i, 64, 32 * count);
+        __m512i matrices = _mm512_loadu_si512(src_bytes + 32 * i);
+        matrices = transpose_bit_16x16_packed_x2_direct(matrices);
+        _mm512_storeu_si512(dst_bytes + 32 * i, matrices);
+    }
+    if (i < count) {
+        transpose_bit_16x16(dst_bytes + 32 * i, src_bytes + 32 * i);
+    }
+}
+
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_16x16_batch(matrices, matrices, count);
+}
+
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        prefetch_batch(src, 128 * i, 256, 128 * count);
+        __m512i matrix_0[2];
+        __m512i matrix_1[2];
+        matrix_0[0] = _mm512_loadu_si512(src_bytes + 128 * i);
+        matrix_0[1] = _mm512_loadu_si512(src_bytes + 128 * i + 64);
+        matrix_1[0] = _mm512_loadu_si512(src_bytes + 128 * i + 128);
+        matrix_1[1] = _mm512_loadu_si512(src_bytes + 128 * i + 192);
+        transpose_bit_32x32_zmm(matrix_0);
+        transpose_bit_32x32_zmm(matrix_1);
+        _mm512_storeu_si512(dst_bytes + 128 * i, matrix_0[0]);
+        _mm512_storeu_si512(dst_bytes + 128 * i + 64, matrix_0[1]);
+        _mm512_storeu_si512(dst_bytes + 128 * i + 128, matrix_1[0]);
+        _mm512_storeu_si512(dst_bytes + 128 * i + 192, matrix_1[1]);
+    }
+    if (i < count) {
+        transpose_bit_32x32(dst_bytes + 128 * i, src_bytes + 128 * i);
+    }
+}
+
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_32x32_batch(matrices, matrices, count);
+}
+
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 512 * i, 512, 512 * count);
+        transpose_bit_64x64(dst_bytes + 512 * i, src_bytes + 512 * i);
+    }
+}
+
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_64x64_batch(matrices, matrices, count);
+}
+
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+        transpose_bit_128x128(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+    }
+}
+
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_128x128_batch(matrices, matrices, count);
+}
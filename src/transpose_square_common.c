@@ -21,13 +21,32 @@
  * SOFTWARE.
  */
 
+#include "bit_transpose_backend.h"
 #include "bit_transpose.h"
+#include "bit_transpose_batch.h"
 
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
+#ifdef __GFNI__
+#include <immintrin.h>
+#endif
+
+const char* transpose_bit_backend(void) {
+  return BITTRANSPOSE_BACKEND_NAME;
+}
+
 uint64_t transpose_bit_8x8_direct(uint64_t x) {
+#ifdef __GFNI__
+  /* With the matrix as operand, GF2P8AFFINEQB computes the product with each
+   * byte of the first operand, where the rows are used in reversed order.  So
+   * we reverse the rows, and multiply with the bytes 0x01, 0x02, ..., 0x80. */
+  const __m128i unit_vectors = _mm_set1_epi64x(0x8040201008040201);
+  __m128i matrix = _mm_cvtsi64_si128((long long)__builtin_bswap64(x));
+  matrix = _mm_gf2p8affine_epi64_epi8(unit_vectors, matrix, 0);
+  return (uint64_t)_mm_cvtsi128_si64(matrix);
+#else
   const uint64_t mask_2x2 = 0x5500550055005500;
   const size_t shift_2x2 = 7;
   const uint64_t mask_4x4 = 0x3333000033330000;
@@ -51,11 +70,34 @@ uint64_t transpose_bit_8x8_direct(uint64_t x) {
   tmp >>= shift_8x8;
   x ^= tmp;
   return x;
+#endif
 }
 
-void transpose_bit_8x8_inplace(void* x) {
+void transpose_bit_8x8(void* dst, const void* src) {
   uint64_t matrix;
-  memcpy(&matrix, x, sizeof(matrix));
+  memcpy(&matrix, src, sizeof(matrix));
   matrix = transpose_bit_8x8_direct(matrix);
-  memcpy(x, &matrix, sizeof(matrix));
+  memcpy(dst, &matrix, sizeof(matrix));
+}
+
+void transpose_bit_8x8_inplace(void* x) {
+  transpose_bit_8x8(x, x);
+}
+
+void transpose_bit_8x8_batch(void* dst, const void* src, size_t count) {
+  const uint8_t* src_bytes = (const uint8_t*)src;
+  uint8_t* dst_bytes = (uint8_t*)dst;
+  size_t i = 0;
+  /* four matrices at once */
+  for (; i + 4 <= count; i += 4) {
+    prefetch_batch(src, 8 * i, 32, 8 * count);
+    transpose_bit_8x8_packed_x4(dst_bytes + 8 * i, src_bytes + 8 * i);
+  }
+  for (; i < count; ++i) {
+    transpose_bit_8x8(dst_bytes + 8 * i, src_bytes + 8 * i);
+  }
+}
+
+void transpose_bit_8x8_batch_inplace(void* matrices, size_t count) {
+  transpose_bit_8x8_batch(matrices, matrices, count);
 }
@@ -21,69 +21,89 @@
  * SOFTWARE.
  */
 
+#include "bit_transpose_backend.h"
 #include "bit_transpose.h"
+#include "bit_transpose_batch.h"
 
 #include <stddef.h>
 #include <string.h>
 
-void transpose_bit_8x8_packed_x4_inplace(void* input) {
+void transpose_bit_8x8_packed_x4(void* dst, const void* src) {
     uint64_t matrices[4];
-    memcpy(matrices, input, 4 * sizeof(uint64_t));
+    memcpy(matrices, src, 4 * sizeof(uint64_t));
     for (size_t i = 0; i < 4; ++i) {
         matrices[i] = transpose_bit_8x8_direct(matrices[i]);
     }
-    memcpy(input, matrices, 4 * sizeof(uint64_t));
+    memcpy(dst, matrices, 4 * sizeof(uint64_t));
+}
+
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src) {
+    transpose_bit_8x8_packed_x4(dst, src);
+}
+
+void transpose_bit_8x8_packed_x4_inplace(void* input) {
+    transpose_bit_8x8_packed_x4(input, input);
 }
 
 void transpose_bit_8x8_packed_x4_inplace_aligned(void* input) {
-    transpose_bit_8x8_packed_x4_inplace(input);
+    transpose_bit_8x8_packed_x4(input, input);
 }
 
-void transpose_bit_16x16_inplace(void* input) {
+void transpose_bit_16x16(void* dst, const void* src) {
     uint16_t tmp[16];
 
     /* aliasing with byte-sized pointers is allowed */
-    uint8_t* input_bytes = (uint8_t*)input;
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
     uint8_t* tmp_bytes = (uint8_t*)tmp;
 
     /* load the four submatrices to the correct positions and swap the
      * antidiagonal ones */
     for (size_t i = 0; i < 8; ++i) {
-        tmp_bytes[i] = input_bytes[2 * i];
-        tmp_bytes[8 + i] = input_bytes[16 + 2 * i];
-        tmp_bytes[16 + i] = input_bytes[2 * i + 1];
-        tmp_bytes[24 + i] = input_bytes[16 + 2 * i + 1];
+        tmp_bytes[i] = src_bytes[2 * i];
+        tmp_bytes[8 + i] = src_bytes[16 + 2 * i];
+        tmp_bytes[16 + i] = src_bytes[2 * i + 1];
+        tmp_bytes[24 + i] = src_bytes[16 + 2 * i + 1];
     }
 
     /* transpose the four submatrices */
     transpose_bit_8x8_packed_x4_inplace(tmp);
 
-    /* write them back */
+    /* write them to the destination */
     for (size_t i = 0; i < 8; ++i) {
-        input_bytes[2 * i] = tmp_bytes[i];
-        input_bytes[2 * i + 1] = tmp_bytes[8 + i];
-        input_bytes[16 + 2 * i] = tmp_bytes[16 + i];
-        input_bytes[16 + 2 * i + 1] = tmp_bytes[24 + i];
+        dst_bytes[2 * i] = tmp_bytes[i];
+        dst_bytes[2 * i + 1] = tmp_bytes[8 + i];
+        dst_bytes[16 + 2 * i] = tmp_bytes[16 + i];
+        dst_bytes[16 + 2 * i + 1] = tmp_bytes[24 + i];
     }
 }
 
+void transpose_bit_16x16_aligned(void* dst, const void* src) {
+    transpose_bit_16x16(dst, src);
+}
+
+void transpose_bit_16x16_inplace(void* input) {
+    transpose_bit_16x16(input, input);
+}
+
 void transpose_bit_16x16_inplace_aligned(void* input) {
-    transpose_bit_16x16_inplace(input);
+    transpose_bit_16x16(input, input);
 }
 
-void transpose_bit_32x32_inplace(void* input) {
+void transpose_bit_32x32(void* dst, const void* src) {
     uint32_t tmp[32];
 
     /* aliasing with byte-sized pointers is allowed */
-    uint8_t* input_bytes = (uint8_t*)input;
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
     uint8_t* tmp_bytes = (uint8_t*)tmp;
 
     /* load the four submatrices to the correct positions and swap the
      * antidiagonal ones */
     for (size_t i = 0; i < 16; ++i) {
         uint16_t buffer[4];
-        memcpy(buffer, input_bytes + 4 * i, 2 * sizeof(uint16_t));
-        memcpy(buffer + 2, input_bytes + 64 + 4 * i, 2 * sizeof(uint16_t));
+        memcpy(buffer, src_bytes + 4 * i, 2 * sizeof(uint16_t));
+        memcpy(buffer + 2, src_bytes + 64 + 4 * i, 2 * sizeof(uint16_t));
         memcpy(tmp_bytes + 2 * i, buffer, sizeof(uint16_t));
         memcpy(tmp_bytes + 32 + 2 * i, buffer + 2, sizeof(uint16_t));
         memcpy(tmp_bytes + 64 + 2 * i, buffer + 1, sizeof(uint16_t));
@@ -95,98 +115,157 @@ void transpose_bit_32x32_inplace(void* input) {
         transpose_bit_16x16_inplace(tmp + i * 8);
     }
 
-    /* write them back */
+    /* write them to the destination */
     for (size_t i = 0; i < 16; ++i) {
         uint16_t buffer[4];
         memcpy(buffer, tmp_bytes + 2 * i, sizeof(uint16_t));
         memcpy(buffer + 1, tmp_bytes + 32 + 2 * i, sizeof(uint16_t));
         memcpy(buffer + 2, tmp_bytes + 64 + 2 * i, sizeof(uint16_t));
         memcpy(buffer + 3, tmp_bytes + 96 + 2 * i, sizeof(uint16_t));
-        memcpy(input_bytes + 4 * i, buffer, 2 * sizeof(uint16_t));
-        memcpy(input_bytes + 64 + 4 * i, buffer + 2, 2 * sizeof(uint16_t));
+        memcpy(dst_bytes + 4 * i, buffer, 2 * sizeof(uint16_t));
+        memcpy(dst_bytes + 64 + 4 * i, buffer + 2, 2 * sizeof(uint16_t));
     }
 }
 
+void transpose_bit_32x32_aligned(void* dst, const void* src) {
+    transpose_bit_32x32(dst, src);
+}
+
+void transpose_bit_32x32_inplace(void* input) {
+    transpose_bit_32x32(input, input);
+}
+
 void transpose_bit_32x32_inplace_aligned(void* input) {
-    return transpose_bit_32x32_inplace(input);
+    transpose_bit_32x32(input, input);
+}
+
+/* Swap the upper right and lower left jxj blocks of each 2jx2j block on the
+ * diagonal of a matrix with the given number of rows of 64 bit words each
+ * (j < 64).  The mask selects the lower j bits of each 2j bits.
+ *
+ * This is one round of the recursive block swap algorithm from Hacker's
+ * Delight (section 7-3).
+ */
+static inline void swap_blocks(uint64_t* rows, size_t num_rows, size_t words_per_row, size_t j,
+                               uint64_t mask) {
+    for (size_t block = 0; block < num_rows; block += 2 * j) {
+        for (size_t k = block * words_per_row; k < (block + j) * words_per_row; ++k) {
+            uint64_t tmp = ((rows[k] >> j) ^ rows[k + j * words_per_row]) & mask;
+            rows[k] ^= tmp << j;
+            rows[k + j * words_per_row] ^= tmp;
+        }
+    }
+}
+
+/* Do the rounds of the block swap algorithm for j = 32, 16, ..., 1.  For rows
+ * of two words, this transposes all four 64x64 submatrices at once.
+ */
+static inline void swap_blocks_64(uint64_t* rows, size_t num_rows, size_t words_per_row) {
+    swap_blocks(rows, num_rows, words_per_row, 32, 0x00000000ffffffff);
+    swap_blocks(rows, num_rows, words_per_row, 16, 0x0000ffff0000ffff);
+    swap_blocks(rows, num_rows, words_per_row, 8, 0x00ff00ff00ff00ff);
+    swap_blocks(rows, num_rows, words_per_row, 4, 0x0f0f0f0f0f0f0f0f);
+    swap_blocks(rows, num_rows, words_per_row, 2, 0x3333333333333333);
+    swap_blocks(rows, num_rows, words_per_row, 1, 0x5555555555555555);
+}
+
+void transpose_bit_64x64(void* dst, const void* src) {
+    uint64_t rows[64];
+    memcpy(rows, src, sizeof(rows));
+    swap_blocks_64(rows, 64, 1);
+    memcpy(dst, rows, sizeof(rows));
+}
+
+void transpose_bit_64x64_aligned(void* dst, const void* src) {
+    transpose_bit_64x64(dst, src);
 }
 
 void transpose_bit_64x64_inplace(void* input) {
-    uint64_t tmp[64];
+    transpose_bit_64x64(input, input);
+}
 
-    /* aliasing with byte-sized pointers is allowed */
-    uint8_t* input_bytes = (uint8_t*)input;
-    uint8_t* tmp_bytes = (uint8_t*)tmp;
+void transpose_bit_64x64_inplace_aligned(void* input) {
+    transpose_bit_64x64(input, input);
+}
 
-    /* load the four submatrices to the correct positions and swap the
-     * antidiagonal ones */
-    for (size_t i = 0; i < 32; ++i) {
-        uint32_t buffer[4];
-        memcpy(buffer, input_bytes + 8 * i, 2 * sizeof(uint32_t));
-        memcpy(buffer + 2, input_bytes + 256 + 8 * i, 2 * sizeof(uint32_t));
-        memcpy(tmp_bytes + 4 * i, buffer, sizeof(uint32_t));
-        memcpy(tmp_bytes + 128 + 4 * i, buffer + 2, sizeof(uint32_t));
-        memcpy(tmp_bytes + 256 + 4 * i, buffer + 1, sizeof(uint32_t));
-        memcpy(tmp_bytes + 384 + 4 * i, buffer + 3, sizeof(uint32_t));
+void transpose_bit_128x128(void* dst, const void* src) {
+    /* each row consists of two 64 bit words */
+    uint64_t rows[256];
+    memcpy(rows, src, sizeof(rows));
+
+    /* swap the upper right and lower left 64x64 submatrices */
+    for (size_t i = 0; i < 64; ++i) {
+        uint64_t tmp = rows[2 * i + 1];
+        rows[2 * i + 1] = rows[128 + 2 * i];
+        rows[128 + 2 * i] = tmp;
     }
 
     /* transpose the four submatrices */
-    for (size_t i = 0; i < 4; ++i) {
-        transpose_bit_32x32_inplace(tmp + i * 16);
-    }
+    swap_blocks_64(rows, 128, 2);
 
-    /* write them back */
-    for (size_t i = 0; i < 32; ++i) {
-        uint32_t buffer[4];
-        memcpy(buffer, tmp_bytes + 4 * i, sizeof(uint32_t));
-        memcpy(buffer + 1, tmp_bytes + 128 + 4 * i, sizeof(uint32_t));
-        memcpy(buffer + 2, tmp_bytes + 256 + 4 * i, sizeof(uint32_t));
-        memcpy(buffer + 3, tmp_bytes + 384 + 4 * i, sizeof(uint32_t));
-        memcpy(input_bytes + 8 * i, buffer, 2 * sizeof(uint32_t));
-        memcpy(input_bytes + 256 + 8 * i, buffer + 2, 2 * sizeof(uint32_t));
-    }
+    memcpy(dst, rows, sizeof(rows));
 }
 
-void transpose_bit_64x64_inplace_aligned(void* input) {
-    transpose_bit_64x64_inplace(input);
+void transpose_bit_128x128_aligned(void* dst, const void* src) {
+    transpose_bit_128x128(dst, src);
 }
 
 void transpose_bit_128x128_inplace(void* input) {
-    uint64_t tmp[256];
+    transpose_bit_128x128(input, input);
+}
 
-    /* aliasing with byte-sized pointers is allowed */
-    uint8_t* input_bytes = (uint8_t*)input;
-    uint8_t* tmp_bytes = (uint8_t*)tmp;
+void transpose_bit_128x128_inplace_aligned(void* input) {
+    transpose_bit_128x128(input, input);
+}
 
-    /* load the four submatrices to the correct positions and swap the
-     * antidiagonal ones */
-    for (size_t i = 0; i < 64; ++i) {
-        uint64_t buffer[4];
-        memcpy(buffer, input_bytes + 16 * i, 2 * sizeof(uint64_t));
-        memcpy(buffer + 2, input_bytes + 1024 + 16 * i, 2 * sizeof(uint64_t));
-        memcpy(tmp_bytes + 8 * i, buffer, sizeof(uint64_t));
-        memcpy(tmp_bytes + 512 + 8 * i, buffer + 2, sizeof(uint64_t));
-        memcpy(tmp_bytes + 1024 + 8 * i, buffer + 1, sizeof(uint64_t));
-        memcpy(tmp_bytes + 1536 + 8 * i, buffer + 3, sizeof(uint64_t));
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 32 * i, 32, 32 * count);
+        transpose_bit_16x16(dst_bytes + 32 * i, src_bytes + 32 * i);
     }
+}
 
-    /* transpose the four submatrices */
-    for (size_t i = 0; i < 4; ++i) {
-        transpose_bit_64x64_inplace(tmp + i * 64);
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_16x16_batch(matrices, matrices, count);
+}
+
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 128 * i, 128, 128 * count);
+        transpose_bit_32x32(dst_bytes + 128 * i, src_bytes + 128 * i);
     }
+}
 
-    /* write them back */
-    for (size_t i = 0; i < 64; ++i) {
-        uint64_t buffer[4];
-        memcpy(buffer, tmp_bytes + 8 * i, sizeof(uint64_t));
-        memcpy(buffer + 1, tmp_bytes + 512 + 8 * i, sizeof(uint64_t));
-        memcpy(buffer + 2, tmp_bytes + 1024 + 8 * i, sizeof(uint64_t));
-        memcpy(buffer + 3, tmp_bytes + 1536 + 8 * i, sizeof(uint64_t));
-        memcpy(input_bytes + 16 * i, buffer, 2 * sizeof(uint64_t));
-        memcpy(input_bytes + 1024 + 16 * i, buffer + 2, 2 * sizeof(uint64_t));
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_32x32_batch(matrices, matrices, count);
+}
+
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 512 * i, 512, 512 * count);
+        transpose_bit_64x64(dst_bytes + 512 * i, src_bytes + 512 * i);
     }
 }
 
-void transpose_bit_128x128_inplace_aligned(void* input) {
-    transpose_bit_128x128_inplace(input);
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_64x64_batch(matrices, matrices, count);
+}
+
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    for (size_t i = 0; i < count; ++i) {
+        prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+        transpose_bit_128x128(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+    }
+}
+
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_128x128_batch(matrices, matrices, count);
 }
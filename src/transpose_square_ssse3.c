@@ -0,0 +1,334 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_batch.h"
+#include "bit_transpose_extra_ssse3.h"
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The kernels for the larger matrices all work the same way: the matrix is
+ * split into its four quadrants which are transposed recursively, the
+ * antidiagonal quadrants are swapped, and the quadrants are merged again by
+ * interleaving the words of their rows.
+ */
+
+__m128i transpose_bit_8x8_packed_x2_direct(__m128i matrix) {
+    const __m128i mask_2x2 = _mm_set1_epi64x(0x5500550055005500);
+    const __m128i mask_4x4 = _mm_set1_epi64x(0x3333000033330000);
+    const __m128i mask_8x8 = _mm_set1_epi64x(0x0f0f0f0f00000000);
+    const int shift_2x2 = 7;
+    const int shift_4x4 = 14;
+    const int shift_8x8 = 28;
+    __m128i tmp;
+
+    tmp = _mm_and_si128(_mm_xor_si128(matrix, _mm_slli_epi64(matrix, shift_2x2)), mask_2x2);
+    matrix = _mm_xor_si128(matrix, tmp);
+    tmp = _mm_srli_epi64(tmp, shift_2x2);
+    matrix = _mm_xor_si128(matrix, tmp);
+
+    tmp = _mm_and_si128(_mm_xor_si128(matrix, _mm_slli_epi64(matrix, shift_4x4)), mask_4x4);
+    matrix = _mm_xor_si128(matrix, tmp);
+    tmp = _mm_srli_epi64(tmp, shift_4x4);
+    matrix = _mm_xor_si128(matrix, tmp);
+
+    tmp = _mm_and_si128(_mm_xor_si128(matrix, _mm_slli_epi64(matrix, shift_8x8)), mask_8x8);
+    matrix = _mm_xor_si128(matrix, tmp);
+    tmp = _mm_srli_epi64(tmp, shift_8x8);
+    matrix = _mm_xor_si128(matrix, tmp);
+    return matrix;
+}
+
+void transpose_bit_8x8_packed_x4(void* dst, const void* src) {
+    __m128i* dst_p = dst;
+    const __m128i* src_p = src;
+    __m128i matrix_0 = transpose_bit_8x8_packed_x2_direct(_mm_loadu_si128(&src_p[0]));
+    __m128i matrix_1 = transpose_bit_8x8_packed_x2_direct(_mm_loadu_si128(&src_p[1]));
+    _mm_storeu_si128(&dst_p[0], matrix_0);
+    _mm_storeu_si128(&dst_p[1], matrix_1);
+}
+
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src) {
+    __m128i* dst_p = dst;
+    const __m128i* src_p = src;
+    __m128i matrix_0 = transpose_bit_8x8_packed_x2_direct(src_p[0]);
+    __m128i matrix_1 = transpose_bit_8x8_packed_x2_direct(src_p[1]);
+    dst_p[0] = matrix_0;
+    dst_p[1] = matrix_1;
+}
+
+void transpose_bit_8x8_packed_x4_inplace(void* input) {
+    transpose_bit_8x8_packed_x4(input, input);
+}
+
+void transpose_bit_8x8_packed_x4_inplace_aligned(void* input) {
+    transpose_bit_8x8_packed_x4_aligned(input, input);
+}
+
+void transpose_bit_16x16_xmm(__m128i* dst, const __m128i* src) {
+    /* separate the low and high bytes of the rows */
+    /* -> [B A] [D C] where A, B, C, D are the 8x8 quadrants */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0d0b0907050301, 0x0e0c0a0806040200);
+    __m128i upper = _mm_shuffle_epi8(src[0], shuffle_mask);
+    __m128i lower = _mm_shuffle_epi8(src[1], shuffle_mask);
+
+    /* transpose the quadrants */
+    upper = transpose_bit_8x8_packed_x2_direct(upper);
+    lower = transpose_bit_8x8_packed_x2_direct(lower);
+
+    /* interleave the bytes again and swap the antidiagonal quadrants */
+    dst[0] = _mm_unpacklo_epi8(upper, lower);
+    dst[1] = _mm_unpackhi_epi8(upper, lower);
+}
+
+void transpose_bit_16x16(void* dst, const void* src) {
+    __m128i matrix[2];
+    memcpy(matrix, src, 2 * 16);
+    transpose_bit_16x16_xmm(matrix, matrix);
+    memcpy(dst, matrix, 2 * 16);
+}
+
+void transpose_bit_16x16_aligned(void* dst, const void* src) {
+    transpose_bit_16x16_xmm(dst, src);
+}
+
+void transpose_bit_16x16_inplace(void* input) {
+    transpose_bit_16x16(input, input);
+}
+
+void transpose_bit_16x16_inplace_aligned(void* input) {
+    transpose_bit_16x16_xmm(input, input);
+}
+
+void transpose_bit_32x32_xmm(__m128i* dst, const __m128i* src) {
+    /* separate the low and high 16 bit words of each four rows */
+    const __m128i shuffle_mask = _mm_set_epi64x(0x0f0e0b0a07060302, 0x0d0c090805040100);
+    __m128i tmp[8];
+
+    /* get the 16x16 quadrants [A B C D] */
+    for (size_t i = 0; i < 4; ++i) {
+        __m128i rows_0 = _mm_shuffle_epi8(src[2 * i], shuffle_mask);
+        __m128i rows_1 = _mm_shuffle_epi8(src[2 * i + 1], shuffle_mask);
+        tmp[4 * (i / 2) + i % 2] = _mm_unpacklo_epi64(rows_0, rows_1);
+        tmp[4 * (i / 2) + 2 + i % 2] = _mm_unpackhi_epi64(rows_0, rows_1);
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_16x16_xmm(&tmp[2 * i], &tmp[2 * i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 4; ++i) {
+        dst[2 * i] = _mm_unpacklo_epi16(tmp[i], tmp[4 + i]);
+        dst[2 * i + 1] = _mm_unpackhi_epi16(tmp[i], tmp[4 + i]);
+    }
+}
+
+void transpose_bit_32x32(void* dst, const void* src) {
+    __m128i matrix[8];
+    memcpy(matrix, src, 8 * 16);
+    transpose_bit_32x32_xmm(matrix, matrix);
+    memcpy(dst, matrix, 8 * 16);
+}
+
+void transpose_bit_32x32_aligned(void* dst, const void* src) {
+    transpose_bit_32x32_xmm(dst, src);
+}
+
+void transpose_bit_32x32_inplace(void* input) {
+    transpose_bit_32x32(input, input);
+}
+
+void transpose_bit_32x32_inplace_aligned(void* input) {
+    transpose_bit_32x32_xmm(input, input);
+}
+
+void transpose_bit_64x64_xmm(__m128i* dst, const __m128i* src) {
+    __m128i tmp[32];
+
+    /* get the 32x32 quadrants [A B C D] */
+    for (size_t i = 0; i < 16; ++i) {
+        /* [3 2 1 0] -> [3 1 2 0] */
+        __m128i rows_0 = _mm_shuffle_epi32(src[2 * i], 0b11011000);
+        __m128i rows_1 = _mm_shuffle_epi32(src[2 * i + 1], 0b11011000);
+        tmp[16 * (i / 8) + i % 8] = _mm_unpacklo_epi64(rows_0, rows_1);
+        tmp[16 * (i / 8) + 8 + i % 8] = _mm_unpackhi_epi64(rows_0, rows_1);
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_32x32_xmm(&tmp[8 * i], &tmp[8 * i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 16; ++i) {
+        dst[2 * i] = _mm_unpacklo_epi32(tmp[i], tmp[16 + i]);
+        dst[2 * i + 1] = _mm_unpackhi_epi32(tmp[i], tmp[16 + i]);
+    }
+}
+
+void transpose_bit_64x64(void* dst, const void* src) {
+    __m128i matrix[32];
+    memcpy(matrix, src, 32 * 16);
+    transpose_bit_64x64_xmm(matrix, matrix);
+    memcpy(dst, matrix, 32 * 16);
+}
+
+void transpose_bit_64x64_aligned(void* dst, const void* src) {
+    transpose_bit_64x64_xmm(dst, src);
+}
+
+void transpose_bit_64x64_inplace(void* input) {
+    transpose_bit_64x64(input, input);
+}
+
+void transpose_bit_64x64_inplace_aligned(void* input) {
+    transpose_bit_64x64_xmm(input, input);
+}
+
+void transpose_bit_128x128_xmm(__m128i* dst, const __m128i* src) {
+    __m128i tmp[128];
+
+    /* get the 64x64 quadrants [A B C D] */
+    for (size_t i = 0; i < 64; ++i) {
+        tmp[64 * (i / 32) + i % 32] = _mm_unpacklo_epi64(src[2 * i], src[2 * i + 1]);
+        tmp[64 * (i / 32) + 32 + i % 32] = _mm_unpackhi_epi64(src[2 * i], src[2 * i + 1]);
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_64x64_xmm(&tmp[32 * i], &tmp[32 * i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 64; ++i) {
+        dst[2 * i] = _mm_unpacklo_epi64(tmp[i], tmp[64 + i]);
+        dst[2 * i + 1] = _mm_unpackhi_epi64(tmp[i], tmp[64 + i]);
+    }
+}
+
+void transpose_bit_128x128(void* dst, const void* src) {
+    __m128i matrix[128];
+    memcpy(matrix, src, 128 * 16);
+    transpose_bit_128x128_xmm(matrix, matrix);
+    memcpy(dst, matrix, 128 * 16);
+}
+
+void transpose_bit_128x128_aligned(void* dst, const void* src) {
+    transpose_bit_128x128_xmm(dst, src);
+}
+
+void transpose_bit_128x128_inplace(void* input) {
+    transpose_bit_128x128(input, input);
+}
+
+void transpose_bit_128x128_inplace_aligned(void* input) {
+    transpose_bit_128x128_xmm(input, input);
+}
+
+/* The batch functions use the aligned kernels directly if possible. */
+
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 32 * i, 32, 32 * count);
+            transpose_bit_16x16_aligned(dst_bytes + 32 * i, src_bytes + 32 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 32 * i, 32, 32 * count);
+            transpose_bit_16x16(dst_bytes + 32 * i, src_bytes + 32 * i);
+        }
+    }
+}
+
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_16x16_batch(matrices, matrices, count);
+}
+
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 128 * i, 128, 128 * count);
+            transpose_bit_32x32_aligned(dst_bytes + 128 * i, src_bytes + 128 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 128 * i, 128, 128 * count);
+            transpose_bit_32x32(dst_bytes + 128 * i, src_bytes + 128 * i);
+        }
+    }
+}
+
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_32x32_batch(matrices, matrices, count);
+}
+
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 512 * i, 512, 512 * count);
+            transpose_bit_64x64_aligned(dst_bytes + 512 * i, src_bytes + 512 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 512 * i, 512, 512 * count);
+            transpose_bit_64x64(dst_bytes + 512 * i, src_bytes + 512 * i);
+        }
+    }
+}
+
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_64x64_batch(matrices, matrices, count);
+}
+
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+            transpose_bit_128x128_aligned(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+            transpose_bit_128x128(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+        }
+    }
+}
+
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_128x128_batch(matrices, matrices, count);
+}
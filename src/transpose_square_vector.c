@@ -0,0 +1,335 @@
+/* MIT License
+ *
+ * Copyright (c) 2020 Lennart Braun
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bit_transpose_backend.h"
+#include "bit_transpose.h"
+#include "bit_transpose_batch.h"
+#include "bit_transpose_extra_vector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The kernels for the larger matrices all work the same way: the matrix is
+ * split into its four quadrants by separating the even and odd words of each
+ * pair of vectors, the quadrants are transposed recursively, and the quadrants
+ * are merged again by interleaving their words.  The antidiagonal quadrants are
+ * swapped on the way.
+ */
+
+void transpose_bit_8x8_packed_x4_vec(u64x4* matrix_p) {
+    u64x4 matrix = *matrix_p;
+    const u64x4 mask_2x2 = {0x5500550055005500, 0x5500550055005500, 0x5500550055005500,
+                            0x5500550055005500};
+    const u64x4 mask_4x4 = {0x3333000033330000, 0x3333000033330000, 0x3333000033330000,
+                            0x3333000033330000};
+    const u64x4 mask_8x8 = {0x0f0f0f0f00000000, 0x0f0f0f0f00000000, 0x0f0f0f0f00000000,
+                            0x0f0f0f0f00000000};
+    const unsigned int shift_2x2 = 7;
+    const unsigned int shift_4x4 = 14;
+    const unsigned int shift_8x8 = 28;
+    u64x4 tmp;
+
+    tmp = (matrix ^ (matrix << shift_2x2)) & mask_2x2;
+    matrix ^= tmp ^ (tmp >> shift_2x2);
+
+    tmp = (matrix ^ (matrix << shift_4x4)) & mask_4x4;
+    matrix ^= tmp ^ (tmp >> shift_4x4);
+
+    tmp = (matrix ^ (matrix << shift_8x8)) & mask_8x8;
+    matrix ^= tmp ^ (tmp >> shift_8x8);
+    *matrix_p = matrix;
+}
+
+void transpose_bit_8x8_packed_x4(void* dst, const void* src) {
+    u64x4 matrix;
+    memcpy(&matrix, src, 32);
+    transpose_bit_8x8_packed_x4_vec(&matrix);
+    memcpy(dst, &matrix, 32);
+}
+
+void transpose_bit_8x8_packed_x4_aligned(void* dst, const void* src) {
+    transpose_bit_8x8_packed_x4(dst, src);
+}
+
+void transpose_bit_8x8_packed_x4_inplace(void* input) {
+    transpose_bit_8x8_packed_x4(input, input);
+}
+
+void transpose_bit_8x8_packed_x4_inplace_aligned(void* input) {
+    transpose_bit_8x8_packed_x4(input, input);
+}
+
+void transpose_bit_16x16_vec(u16x16* dst, const u16x16* src) {
+    /* gather the 8x8 quadrants A, C, B, D into the four 64 bit words */
+    u8x32 bytes = (u8x32)*src;
+    bytes = SHUFFLE(u8x32, bytes, bytes, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+                    1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+
+    /* transpose them */
+    u64x4 blocks = (u64x4)bytes;
+    transpose_bit_8x8_packed_x4_vec(&blocks);
+    bytes = (u8x32)blocks;
+
+    /* interleave the bytes of A and C, and of B and D */
+    bytes = SHUFFLE(u8x32, bytes, bytes, 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15, 16,
+                    24, 17, 25, 18, 26, 19, 27, 20, 28, 21, 29, 22, 30, 23, 31);
+    *dst = (u16x16)bytes;
+}
+
+void transpose_bit_16x16(void* dst, const void* src) {
+    u16x16 matrix;
+    memcpy(&matrix, src, 32);
+    transpose_bit_16x16_vec(&matrix, &matrix);
+    memcpy(dst, &matrix, 32);
+}
+
+void transpose_bit_16x16_aligned(void* dst, const void* src) {
+    transpose_bit_16x16_vec(dst, src);
+}
+
+void transpose_bit_16x16_inplace(void* input) {
+    transpose_bit_16x16(input, input);
+}
+
+void transpose_bit_16x16_inplace_aligned(void* input) {
+    transpose_bit_16x16_vec(input, input);
+}
+
+void transpose_bit_32x32_vec(u32x8* dst, const u32x8* src) {
+    u16x16 tmp[4];
+
+    /* get the 16x16 quadrants [A B C D] */
+    for (size_t i = 0; i < 2; ++i) {
+        tmp[2 * i] = (u16x16)src[2 * i];
+        tmp[2 * i + 1] = (u16x16)src[2 * i + 1];
+        split_u16x16(&tmp[2 * i], &tmp[2 * i + 1]);
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_16x16_vec(&tmp[i], &tmp[i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 2; ++i) {
+        u16x16 lo = tmp[i];
+        u16x16 hi = tmp[2 + i];
+        merge_u16x16(&lo, &hi);
+        dst[2 * i] = (u32x8)lo;
+        dst[2 * i + 1] = (u32x8)hi;
+    }
+}
+
+void transpose_bit_32x32(void* dst, const void* src) {
+    u32x8 matrix[4];
+    memcpy(matrix, src, 4 * 32);
+    transpose_bit_32x32_vec(matrix, matrix);
+    memcpy(dst, matrix, 4 * 32);
+}
+
+void transpose_bit_32x32_aligned(void* dst, const void* src) {
+    transpose_bit_32x32_vec(dst, src);
+}
+
+void transpose_bit_32x32_inplace(void* input) {
+    transpose_bit_32x32(input, input);
+}
+
+void transpose_bit_32x32_inplace_aligned(void* input) {
+    transpose_bit_32x32_vec(input, input);
+}
+
+void transpose_bit_64x64_vec(u64x4* dst, const u64x4* src) {
+    u32x8 tmp[16];
+
+    /* get the 32x32 quadrants [A B C D] */
+    for (size_t i = 0; i < 8; ++i) {
+        u32x8 even = (u32x8)src[2 * i];
+        u32x8 odd = (u32x8)src[2 * i + 1];
+        split_u32x8(&even, &odd);
+        tmp[8 * (i / 4) + i % 4] = even;
+        tmp[8 * (i / 4) + 4 + i % 4] = odd;
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_32x32_vec(&tmp[4 * i], &tmp[4 * i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 8; ++i) {
+        u32x8 lo = tmp[i];
+        u32x8 hi = tmp[8 + i];
+        merge_u32x8(&lo, &hi);
+        dst[2 * i] = (u64x4)lo;
+        dst[2 * i + 1] = (u64x4)hi;
+    }
+}
+
+void transpose_bit_64x64(void* dst, const void* src) {
+    u64x4 matrix[16];
+    memcpy(matrix, src, 16 * 32);
+    transpose_bit_64x64_vec(matrix, matrix);
+    memcpy(dst, matrix, 16 * 32);
+}
+
+void transpose_bit_64x64_aligned(void* dst, const void* src) {
+    transpose_bit_64x64_vec(dst, src);
+}
+
+void transpose_bit_64x64_inplace(void* input) {
+    transpose_bit_64x64(input, input);
+}
+
+void transpose_bit_64x64_inplace_aligned(void* input) {
+    transpose_bit_64x64_vec(input, input);
+}
+
+void transpose_bit_128x128_vec(u64x4* dst, const u64x4* src) {
+    u64x4 tmp[64];
+
+    /* get the 64x64 quadrants [A B C D] */
+    for (size_t i = 0; i < 32; ++i) {
+        u64x4 even = src[2 * i];
+        u64x4 odd = src[2 * i + 1];
+        split_u64x4(&even, &odd);
+        tmp[32 * (i / 16) + i % 16] = even;
+        tmp[32 * (i / 16) + 16 + i % 16] = odd;
+    }
+
+    /* transpose them */
+    for (size_t i = 0; i < 4; ++i) {
+        transpose_bit_64x64_vec(&tmp[16 * i], &tmp[16 * i]);
+    }
+
+    /* merge the quadrants [A B] and [C D] and thereby swap B and C */
+    for (size_t i = 0; i < 32; ++i) {
+        u64x4 lo = tmp[i];
+        u64x4 hi = tmp[32 + i];
+        merge_u64x4(&lo, &hi);
+        dst[2 * i] = lo;
+        dst[2 * i + 1] = hi;
+    }
+}
+
+void transpose_bit_128x128(void* dst, const void* src) {
+    u64x4 matrix[64];
+    memcpy(matrix, src, 64 * 32);
+    transpose_bit_128x128_vec(matrix, matrix);
+    memcpy(dst, matrix, 64 * 32);
+}
+
+void transpose_bit_128x128_aligned(void* dst, const void* src) {
+    transpose_bit_128x128_vec(dst, src);
+}
+
+void transpose_bit_128x128_inplace(void* input) {
+    transpose_bit_128x128(input, input);
+}
+
+void transpose_bit_128x128_inplace_aligned(void* input) {
+    transpose_bit_128x128_vec(input, input);
+}
+
+/* The batch functions use the aligned kernels directly if possible. */
+
+void transpose_bit_16x16_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 32 * i, 32, 32 * count);
+            transpose_bit_16x16_aligned(dst_bytes + 32 * i, src_bytes + 32 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 32 * i, 32, 32 * count);
+            transpose_bit_16x16(dst_bytes + 32 * i, src_bytes + 32 * i);
+        }
+    }
+}
+
+void transpose_bit_16x16_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_16x16_batch(matrices, matrices, count);
+}
+
+void transpose_bit_32x32_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 128 * i, 128, 128 * count);
+            transpose_bit_32x32_aligned(dst_bytes + 128 * i, src_bytes + 128 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 128 * i, 128, 128 * count);
+            transpose_bit_32x32(dst_bytes + 128 * i, src_bytes + 128 * i);
+        }
+    }
+}
+
+void transpose_bit_32x32_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_32x32_batch(matrices, matrices, count);
+}
+
+void transpose_bit_64x64_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 512 * i, 512, 512 * count);
+            transpose_bit_64x64_aligned(dst_bytes + 512 * i, src_bytes + 512 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 512 * i, 512, 512 * count);
+            transpose_bit_64x64(dst_bytes + 512 * i, src_bytes + 512 * i);
+        }
+    }
+}
+
+void transpose_bit_64x64_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_64x64_batch(matrices, matrices, count);
+}
+
+void transpose_bit_128x128_batch(void* dst, const void* src, size_t count) {
+    const uint8_t* src_bytes = (const uint8_t*)src;
+    uint8_t* dst_bytes = (uint8_t*)dst;
+    if ((((uintptr_t)(dst) | (uintptr_t)(src)) & 31) == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+            transpose_bit_128x128_aligned(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            prefetch_batch(src, 2048 * i, 2048, 2048 * count);
+            transpose_bit_128x128(dst_bytes + 2048 * i, src_bytes + 2048 * i);
+        }
+    }
+}
+
+void transpose_bit_128x128_batch_inplace(void* matrices, size_t count) {
+    transpose_bit_128x128_batch(matrices, matrices, count);
+}
@@ -0,0 +1,39 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <bit_transpose.h>
+#include <catch2/catch.hpp>
+#include <set>
+#include <string>
+
+TEST_CASE("selected backend", "[backend]") {
+    const std::set<std::string> backends = {
+        "plain", "vector", "ssse3", "avx2", "avx2_gfni", "avx512", "avx512_gfni",
+    };
+    const char* backend = transpose_bit_backend();
+    REQUIRE(backend != nullptr);
+    REQUIRE(backends.count(backend) == 1);
+#ifdef BITTRANSPOSE_EXPECTED_BACKEND
+    REQUIRE(std::string(backend) == BITTRANSPOSE_EXPECTED_BACKEND);
+#endif
+}
@@ -25,6 +25,8 @@
 #include <catch2/catch.hpp>
 #include <cstdint>
 #include <cstring>
+#include <random>
+#include <vector>
 
 TEST_CASE("rectangular 8xN bit transpositions", "[8] [rectangular]") {
     constexpr std::size_t N_max = 9;
@@ -62,6 +64,42 @@ TEST_CASE("rectangular Nx8 bit transpositions", "[8] [rectangular]") {
     }
 }
 
+TEST_CASE("rectangular 8xN/Nx8 bit transpositions with wide super blocks", "[8] [rectangular]") {
+    // N >= 32 runs through the super blocks of 32 blocks, 67 also leaves a remainder
+    std::mt19937_64 mt(0);
+    for (std::size_t N : {32, 67}) {
+        // offset the rows and the packed matrix by one byte so that nothing is aligned
+        std::vector<std::vector<std::uint8_t>> rows(8, std::vector<std::uint8_t>(N + 1));
+        std::vector<const std::uint8_t*> input_ptrs(8);
+        for (std::size_t i = 0; i < 8; ++i) {
+            std::generate(rows[i].begin(), rows[i].end(), [&] { return mt(); });
+            input_ptrs[i] = rows[i].data() + 1;
+        }
+        std::vector<std::uint8_t> packed(8 * N + 1, 0x00);
+        transpose_bit_8xN(packed.data() + 1, input_ptrs.data(), N);
+        bool correct = true;
+        for (std::size_t block_i = 0; block_i < N; ++block_i) {
+            for (std::size_t r = 0; r < 8; ++r) {
+                for (std::size_t c = 0; c < 8; ++c) {
+                    const int expected = (input_ptrs[c][block_i] >> r) & 1;
+                    correct = correct && ((packed[1 + 8 * block_i + r] >> c) & 1) == expected;
+                }
+            }
+        }
+        REQUIRE(correct);
+
+        std::vector<std::vector<std::uint8_t>> computed(8, std::vector<std::uint8_t>(N + 1, 0x00));
+        std::vector<std::uint8_t*> output_ptrs(8);
+        for (std::size_t i = 0; i < 8; ++i) {
+            output_ptrs[i] = computed[i].data() + 1;
+        }
+        transpose_bit_Nx8(output_ptrs.data(), packed.data() + 1, N);
+        for (std::size_t i = 0; i < 8; ++i) {
+            REQUIRE(std::memcmp(output_ptrs[i], input_ptrs[i], N) == 0);
+        }
+    }
+}
+
 TEST_CASE("rectangular 16xN bit transpositions", "[16] [rectangular]") {
     constexpr std::size_t N_max = 9;
     std::array<std::uint16_t, 16 * N_max> computed alignas(32) = {0};
@@ -206,3 +244,390 @@ TEST_CASE("rectangular Nx128 bit transpositions", "[128] [rectangular]") {
         }
     }
 }
+
+TEST_CASE("rectangular 64xN bit transpositions with streaming stores", "[64] [rectangular] [nt]") {
+    constexpr std::size_t N_max = 9;
+    std::array<std::uint64_t, 64 * N_max> computed alignas(64) = {0};
+    std::array<const std::uint8_t*, 64> input_ptrs;
+    for (std::size_t i = 0; i < 64; ++i) {
+        input_ptrs[i] = reinterpret_cast<const std::uint8_t*>(input_64x576.data() + i * N_max);
+    }
+    for (std::size_t N = 1; N <= N_max; ++N) {
+        std::fill(std::begin(computed), std::end(computed), 0x00);
+        transpose_bit_64xN_nt(computed.data(), input_ptrs.data(), N);
+        REQUIRE(std::memcmp(computed.data(), output_64x576.data(),
+                            64 * N * sizeof(decltype(computed)::value_type))
+                == 0);
+    }
+}
+
+TEST_CASE("rectangular 128xN bit transpositions with streaming stores", "[128] [rectangular] [nt]") {
+    constexpr std::size_t N_max = 9;
+    std::array<__m128i, 128 * N_max> computed alignas(64) = {0};
+    std::array<const std::uint8_t*, 128> input_ptrs;
+    for (std::size_t i = 0; i < 128; ++i) {
+        input_ptrs[i] = reinterpret_cast<const std::uint8_t*>(input_128x1152.data() + i * N_max);
+    }
+    for (std::size_t N = 1; N <= N_max; ++N) {
+        std::fill(std::begin(computed), std::end(computed), _mm_set1_epi64x(0x00));
+        transpose_bit_128xN_nt(reinterpret_cast<std::uint8_t*>(computed.data()), input_ptrs.data(),
+                               N);
+        REQUIRE(std::memcmp(computed.data(), output_128x1152.data(),
+                            128 * N * sizeof(decltype(computed)::value_type))
+                == 0);
+    }
+}
+
+TEST_CASE("rectangular Nx128 bit transpositions with streaming stores", "[128] [rectangular] [nt]") {
+    constexpr std::size_t N_max = 9;
+    // pad the rows to a multiple of 64 bytes, such that all of them are aligned
+    constexpr std::size_t row_size = 12;
+    std::array<__m128i, 128 * row_size> computed alignas(64) = {0};
+    std::array<std::uint8_t*, 128> output_ptrs;
+    for (std::size_t i = 0; i < 128; ++i) {
+        output_ptrs[i] = reinterpret_cast<std::uint8_t*>(computed.data() + i * row_size);
+    }
+    for (std::size_t N = 1; N <= N_max; ++N) {
+        std::fill(std::begin(computed), std::end(computed), _mm_set1_epi64x(0x00));
+        transpose_bit_Nx128_nt(output_ptrs.data(),
+                               reinterpret_cast<const std::uint8_t*>(output_128x1152.data()), N);
+        for (std::size_t i = 0; i < 128; ++i) {
+            REQUIRE(std::memcmp(computed.data() + i * row_size, input_128x1152.data() + i * N_max,
+                                N * sizeof(decltype(computed)::value_type))
+                    == 0);
+        }
+    }
+}
+
+TEST_CASE("rectangular Nx64/Nx128 bit transpositions with staged writes", "[rectangular] [staged]") {
+    std::mt19937_64 mt(0);
+    // the numbers of blocks cover several staging tiles and a partial one
+    for (std::size_t N : {1, 9, 33, 100}) {
+        std::vector<std::uint64_t> src(256 * N);
+        std::generate(src.begin(), src.end(), [&] { return mt(); });
+        for (std::size_t k : {64, 128}) {
+            const std::size_t row_size = k / 8 * N;
+            std::vector<std::uint8_t> expected(k * row_size);
+            std::vector<std::uint8_t> computed(k * row_size);
+            std::vector<std::uint8_t*> expected_ptrs(k);
+            std::vector<std::uint8_t*> computed_ptrs(k);
+            for (std::size_t i = 0; i < k; ++i) {
+                expected_ptrs[i] = expected.data() + i * row_size;
+                computed_ptrs[i] = computed.data() + i * row_size;
+            }
+            if (k == 64) {
+                transpose_bit_Nx64(expected_ptrs.data(), src.data(), N);
+                transpose_bit_Nx64_staged(computed_ptrs.data(), src.data(), N);
+            } else {
+                const auto src_bytes = reinterpret_cast<const std::uint8_t*>(src.data());
+                transpose_bit_Nx128(expected_ptrs.data(), src_bytes, N);
+                transpose_bit_Nx128_staged(computed_ptrs.data(), src_bytes, N);
+            }
+            REQUIRE(computed == expected);
+        }
+    }
+}
+
+// The input of size k x (9 * k) consists of k rows of 9 elements of type T
+// (where k is the number of bits of T), and the output of 9 blocks of size
+// k x k.  Test the _aligned variants with a 32-byte aligned buffer of blocks,
+// and the regular functions also with a buffer that is only 8-byte aligned.
+template <typename W, typename T, std::size_t M>
+static void check_aligned(const std::array<T, M>& input, const std::array<T, M>& output,
+                          void (*kxN)(W*, const std::uint8_t* const*, std::size_t),
+                          void (*kxN_aligned)(W*, const std::uint8_t* const*, std::size_t),
+                          void (*Nxk)(std::uint8_t**, const W*, std::size_t),
+                          void (*Nxk_aligned)(std::uint8_t**, const W*, std::size_t)) {
+    constexpr std::size_t N_max = 9;
+    constexpr std::size_t k = 8 * sizeof(T);
+    constexpr std::size_t row_size = N_max * sizeof(T);
+    constexpr std::size_t block_size = k * sizeof(T);
+    const auto input_bytes = reinterpret_cast<const std::uint8_t*>(input.data());
+    const auto output_bytes = reinterpret_cast<const std::uint8_t*>(output.data());
+    alignas(32) std::array<std::uint8_t, N_max * block_size + 32> buffer;
+    std::vector<std::uint8_t> rows(k * row_size);
+    std::array<const std::uint8_t*, k> input_ptrs;
+    std::array<std::uint8_t*, k> row_ptrs;
+    for (std::size_t i = 0; i < k; ++i) {
+        input_ptrs[i] = input_bytes + i * row_size;
+        row_ptrs[i] = rows.data() + i * row_size;
+    }
+    for (std::size_t offset : {0, 8}) {
+        const auto blocks = reinterpret_cast<W*>(buffer.data() + offset);
+        for (std::size_t N = 1; N <= N_max; ++N) {
+            for (bool aligned : {false, true}) {
+                if (aligned && offset != 0) {
+                    continue;
+                }
+                buffer.fill(0x00);
+                (aligned ? kxN_aligned : kxN)(blocks, input_ptrs.data(), N);
+                REQUIRE(std::memcmp(buffer.data() + offset, output_bytes, N * block_size) == 0);
+                std::fill(rows.begin(), rows.end(), 0x00);
+                (aligned ? Nxk_aligned : Nxk)(row_ptrs.data(), blocks, N);
+                for (std::size_t i = 0; i < k; ++i) {
+                    REQUIRE(std::memcmp(rows.data() + i * row_size, input_bytes + i * row_size,
+                                        N * sizeof(T))
+                            == 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("rectangular 8xN/Nx8 bit transpositions aligned", "[8] [rectangular] [aligned]") {
+    check_aligned(input_8x72, output_8x72, transpose_bit_8xN, transpose_bit_8xN_aligned,
+                  transpose_bit_Nx8, transpose_bit_Nx8_aligned);
+}
+
+TEST_CASE("rectangular 16xN/Nx16 bit transpositions aligned", "[16] [rectangular] [aligned]") {
+    check_aligned(input_16x144, output_16x144, transpose_bit_16xN, transpose_bit_16xN_aligned,
+                  transpose_bit_Nx16, transpose_bit_Nx16_aligned);
+}
+
+TEST_CASE("rectangular 32xN/Nx32 bit transpositions aligned", "[32] [rectangular] [aligned]") {
+    check_aligned(input_32x288, output_32x288, transpose_bit_32xN, transpose_bit_32xN_aligned,
+                  transpose_bit_Nx32, transpose_bit_Nx32_aligned);
+}
+
+TEST_CASE("rectangular 64xN/Nx64 bit transpositions aligned", "[64] [rectangular] [aligned]") {
+    check_aligned(input_64x576, output_64x576, transpose_bit_64xN, transpose_bit_64xN_aligned,
+                  transpose_bit_Nx64, transpose_bit_Nx64_aligned);
+}
+
+TEST_CASE("rectangular 128xN/Nx128 bit transpositions aligned", "[128] [rectangular] [aligned]") {
+    check_aligned(input_128x1152, output_128x1152, transpose_bit_128xN,
+                  transpose_bit_128xN_aligned, transpose_bit_Nx128, transpose_bit_Nx128_aligned);
+}
+
+using strided_function = void (*)(std::uint8_t*, std::size_t, const std::uint8_t*, std::size_t,
+                                  std::size_t);
+
+// The input of size k x (9 * k) consists of k rows of 9 elements of type T
+// (where k is the number of bits of T), and the output of 9 * k rows of one
+// element each.  Test the strided transpositions with packed rows and with
+// rows which are padded by an odd number of bytes.
+template <typename T, std::size_t M>
+static void check_strided(const std::array<T, M>& input, const std::array<T, M>& output,
+                          strided_function kxN, strided_function Nxk) {
+    constexpr std::size_t N_max = 9;
+    constexpr std::size_t k = 8 * sizeof(T);
+    constexpr std::size_t row_size = sizeof(T);
+    const auto input_bytes = reinterpret_cast<const std::uint8_t*>(input.data());
+    const auto output_bytes = reinterpret_cast<const std::uint8_t*>(output.data());
+    for (std::size_t tall_stride : {row_size, row_size + 3}) {
+        const std::size_t wide_stride = N_max * row_size + 5;
+        std::vector<std::uint8_t> tall(k * N_max * tall_stride);
+        std::vector<std::uint8_t> wide(k * wide_stride);
+        for (std::size_t j = 0; j < k * N_max; ++j) {
+            std::memcpy(tall.data() + j * tall_stride, output_bytes + j * row_size, row_size);
+        }
+        for (std::size_t i = 0; i < k; ++i) {
+            std::memcpy(wide.data() + i * wide_stride, input_bytes + i * N_max * row_size,
+                        N_max * row_size);
+        }
+        for (std::size_t N = 1; N <= N_max; ++N) {
+            std::vector<std::uint8_t> computed(k * N_max * tall_stride, 0x00);
+            kxN(computed.data(), tall_stride, wide.data(), wide_stride, N);
+            for (std::size_t j = 0; j < k * N; ++j) {
+                REQUIRE(std::memcmp(computed.data() + j * tall_stride, output_bytes + j * row_size,
+                                    row_size)
+                        == 0);
+            }
+            computed.assign(k * wide_stride, 0x00);
+            Nxk(computed.data(), wide_stride, tall.data(), tall_stride, N);
+            for (std::size_t i = 0; i < k; ++i) {
+                REQUIRE(std::memcmp(computed.data() + i * wide_stride,
+                                    input_bytes + i * N_max * row_size, N * row_size)
+                        == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("rectangular 8xN/Nx8 bit transpositions with strides", "[8] [rectangular] [strided]") {
+    check_strided(input_8x72, output_8x72, transpose_bit_8xN_strided, transpose_bit_Nx8_strided);
+}
+
+TEST_CASE("rectangular 16xN/Nx16 bit transpositions with strides", "[16] [rectangular] [strided]") {
+    check_strided(input_16x144, output_16x144, transpose_bit_16xN_strided,
+                  transpose_bit_Nx16_strided);
+}
+
+TEST_CASE("rectangular 32xN/Nx32 bit transpositions with strides", "[32] [rectangular] [strided]") {
+    check_strided(input_32x288, output_32x288, transpose_bit_32xN_strided,
+                  transpose_bit_Nx32_strided);
+}
+
+TEST_CASE("rectangular 64xN/Nx64 bit transpositions with strides", "[64] [rectangular] [strided]") {
+    check_strided(input_64x576, output_64x576, transpose_bit_64xN_strided,
+                  transpose_bit_Nx64_strided);
+}
+
+TEST_CASE("rectangular 128xN/Nx128 bit transpositions with strides",
+          "[128] [rectangular] [strided]") {
+    check_strided(input_128x1152, output_128x1152, transpose_bit_128xN_strided,
+                  transpose_bit_Nx128_strided);
+}
+
+// Test the transpositions with a number of columns (or rows) in bits.  Bytes
+// (and bits of the last byte) after the valid part of the output must not be
+// written.
+template <typename T, std::size_t M, typename KxN, typename NxK>
+static void check_bits(const std::array<T, M>& input, const std::array<T, M>& output, KxN kxN,
+                       NxK Nxk) {
+    constexpr std::size_t N_max = 9;
+    constexpr std::size_t k = 8 * sizeof(T);
+    constexpr std::size_t row_size = sizeof(T);
+    constexpr std::uint8_t sentinel = 0xab;
+    const auto input_bytes = reinterpret_cast<const std::uint8_t*>(input.data());
+    const auto output_bytes = reinterpret_cast<const std::uint8_t*>(output.data());
+    std::array<const std::uint8_t*, k> input_ptrs;
+    for (std::size_t i = 0; i < k; ++i) {
+        input_ptrs[i] = input_bytes + i * N_max * row_size;
+    }
+    for (std::size_t num_cols = 1; num_cols <= N_max * k; ++num_cols) {
+        std::array<T, M> computed;
+        auto computed_bytes = reinterpret_cast<std::uint8_t*>(computed.data());
+        std::memset(computed_bytes, sentinel, sizeof(computed));
+        kxN(computed.data(), input_ptrs.data(), num_cols);
+        bool correct = std::memcmp(computed_bytes, output_bytes, num_cols * row_size) == 0;
+        for (std::size_t i = num_cols * row_size; i < sizeof(computed); ++i) {
+            correct = correct && computed_bytes[i] == sentinel;
+        }
+        REQUIRE(correct);
+
+        std::memset(computed_bytes, sentinel, sizeof(computed));
+        std::array<std::uint8_t*, k> output_ptrs;
+        for (std::size_t i = 0; i < k; ++i) {
+            output_ptrs[i] = computed_bytes + i * N_max * row_size;
+        }
+        Nxk(output_ptrs.data(), output.data(), num_cols);
+        const std::size_t num_bytes = num_cols / 8;
+        const std::uint8_t mask = (1u << (num_cols % 8)) - 1;
+        correct = true;
+        for (std::size_t i = 0; i < k; ++i) {
+            const std::uint8_t* row = output_ptrs[i];
+            const std::uint8_t* expected = input_ptrs[i];
+            correct = correct && std::memcmp(row, expected, num_bytes) == 0;
+            if (mask != 0) {
+                correct = correct && ((row[num_bytes] ^ expected[num_bytes]) & mask) == 0;
+                correct = correct && ((row[num_bytes] ^ sentinel) & ~mask) == 0;
+            }
+            for (std::size_t j = num_bytes + (mask != 0); j < N_max * row_size; ++j) {
+                correct = correct && row[j] == sentinel;
+            }
+        }
+        REQUIRE(correct);
+    }
+}
+
+TEST_CASE("rectangular 8xN/Nx8 bit transpositions with bit counts", "[8] [rectangular] [bits]") {
+    check_bits(input_8x72, output_8x72, transpose_bit_8xN_bits, transpose_bit_Nx8_bits);
+}
+
+TEST_CASE("rectangular 16xN/Nx16 bit transpositions with bit counts", "[16] [rectangular] [bits]") {
+    check_bits(input_16x144, output_16x144, transpose_bit_16xN_bits, transpose_bit_Nx16_bits);
+}
+
+TEST_CASE("rectangular 32xN/Nx32 bit transpositions with bit counts", "[32] [rectangular] [bits]") {
+    check_bits(input_32x288, output_32x288, transpose_bit_32xN_bits, transpose_bit_Nx32_bits);
+}
+
+TEST_CASE("rectangular 64xN/Nx64 bit transpositions with bit counts", "[64] [rectangular] [bits]") {
+    check_bits(input_64x576, output_64x576, transpose_bit_64xN_bits, transpose_bit_Nx64_bits);
+}
+
+TEST_CASE("rectangular 128xN/Nx128 bit transpositions with bit counts",
+          "[128] [rectangular] [bits]") {
+    check_bits(input_128x1152, output_128x1152,
+               [](__m128i* dst, const std::uint8_t* const* src, std::size_t num_cols) {
+                   transpose_bit_128xN_bits(reinterpret_cast<std::uint8_t*>(dst), src, num_cols);
+               },
+               [](std::uint8_t** dst, const __m128i* src, std::size_t num_rows) {
+                   transpose_bit_Nx128_bits(dst, reinterpret_cast<const std::uint8_t*>(src),
+                                            num_rows);
+               });
+}
+
+static bool get_bit(const std::uint8_t* row, std::size_t j) { return (row[j / 8] >> (j % 8)) & 1; }
+
+TEST_CASE("rectangular kxN/Nxk bit transpositions with arbitrary k", "[rectangular] [any_k]") {
+    std::mt19937_64 mt(0);
+    for (std::size_t k : {1, 3, 7, 12, 16, 40, 64, 80, 100, 160, 200}) {
+        const std::size_t row_size = (k + 7) / 8;
+        for (std::size_t num_cols : {1, 13, 128, 600, 1100}) {
+            const std::size_t num_bytes = (num_cols + 7) / 8;
+            std::vector<std::vector<std::uint8_t>> rows(k, std::vector<std::uint8_t>(num_bytes));
+            std::vector<const std::uint8_t*> row_ptrs(k);
+            for (std::size_t i = 0; i < k; ++i) {
+                std::generate(rows[i].begin(), rows[i].end(), [&] { return mt(); });
+                row_ptrs[i] = rows[i].data();
+            }
+            std::vector<std::uint8_t> tall(num_cols * row_size, 0xab);
+            transpose_bit_kxN(tall.data(), row_ptrs.data(), k, num_cols);
+            bool correct = true;
+            for (std::size_t c = 0; c < num_cols; ++c) {
+                for (std::size_t r = 0; r < 8 * row_size; ++r) {
+                    const bool expected = r < k && get_bit(rows[r].data(), c);
+                    correct = correct && get_bit(tall.data() + c * row_size, r) == expected;
+                }
+            }
+            REQUIRE(correct);
+
+            std::vector<std::vector<std::uint8_t>> computed(
+                k, std::vector<std::uint8_t>(num_bytes, 0xab));
+            std::vector<std::uint8_t*> computed_ptrs(k);
+            for (std::size_t i = 0; i < k; ++i) {
+                computed_ptrs[i] = computed[i].data();
+            }
+            transpose_bit_Nxk(computed_ptrs.data(), tall.data(), k, num_cols);
+            for (std::size_t i = 0; i < k; ++i) {
+                for (std::size_t c = 0; c < 8 * num_bytes; ++c) {
+                    // the bits after the last column keep their previous value
+                    const std::uint8_t previous = 0xab;
+                    const bool expected = c < num_cols ? get_bit(rows[i].data(), c)
+                                                       : get_bit(&previous, c % 8);
+                    correct = correct && get_bit(computed[i].data(), c) == expected;
+                }
+            }
+            REQUIRE(correct);
+        }
+    }
+}
+
+using matrix_transpose_fun = void (*)(std::uint8_t*, std::size_t, const std::uint8_t*,
+                                      std::size_t, std::size_t, std::size_t);
+
+static void check_matrix(matrix_transpose_fun transpose) {
+    std::mt19937_64 mt(0);
+    for (std::size_t num_rows : {1, 7, 8, 100, 128, 300, 640, 1030}) {
+        for (std::size_t num_cols : {1, 13, 64, 128, 515, 1024, 1100}) {
+            // both matrices are stored with a few padding bytes after each row
+            const std::size_t src_stride = (num_cols + 7) / 8 + 3;
+            const std::size_t dst_stride = (num_rows + 7) / 8 + 5;
+            std::vector<std::uint8_t> src(num_rows * src_stride);
+            std::generate(src.begin(), src.end(), [&] { return mt(); });
+            std::vector<std::uint8_t> dst(num_cols * dst_stride, 0xab);
+            transpose(dst.data(), dst_stride, src.data(), src_stride, num_rows, num_cols);
+            bool correct = true;
+            for (std::size_t c = 0; c < num_cols; ++c) {
+                for (std::size_t r = 0; r < 8 * dst_stride; ++r) {
+                    // the bits after the last column of dst keep their previous value
+                    const std::uint8_t previous = 0xab;
+                    const bool expected = r < num_rows ? get_bit(src.data() + r * src_stride, c)
+                                                       : get_bit(&previous, r % 8);
+                    correct = correct && get_bit(dst.data() + c * dst_stride, r) == expected;
+                }
+            }
+            REQUIRE(correct);
+        }
+    }
+}
+
+TEST_CASE("bit matrix transposition of arbitrary size", "[rectangular] [matrix]") {
+    check_matrix(transpose_bit_matrix);
+}
+
+TEST_CASE("recursive bit matrix transposition of arbitrary size", "[rectangular] [matrix]") {
+    check_matrix(transpose_bit_matrix_recursive);
+}
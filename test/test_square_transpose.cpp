@@ -57,6 +57,25 @@ TEST_CASE("packed square 8x8 bit transpositions aligned", "[8] [square] [packed]
     REQUIRE(computed == output_8x8_packed);
 }
 
+TEST_CASE("square 8x8 bit transpositions out of place", "[8] [square]") {
+    std::array<std::uint8_t, 8> computed;
+    transpose_bit_8x8(computed.data(), input_8x8.data());
+    REQUIRE(computed == output_8x8);
+}
+
+TEST_CASE("packed square 8x8 bit transpositions out of place", "[8] [square] [packed]") {
+    std::array<std::uint8_t, 4 * 8> computed;
+    transpose_bit_8x8_packed_x4(computed.data(), input_8x8_packed.data());
+    REQUIRE(computed == output_8x8_packed);
+}
+
+TEST_CASE("packed square 8x8 bit transpositions out of place aligned",
+          "[8] [square] [packed] [aligned]") {
+    std::array<std::uint8_t, 4 * 8> computed alignas(32);
+    transpose_bit_8x8_packed_x4_aligned(computed.data(), input_8x8_packed.data());
+    REQUIRE(computed == output_8x8_packed);
+}
+
 TEST_CASE("square 16x16 bit transpositions", "[16] [square]") {
     std::array<std::uint16_t, 16> computed;
     std::copy(std::begin(input_16x16), std::end(input_16x16), std::begin(computed));
@@ -71,6 +90,18 @@ TEST_CASE("square 16x16 bit transpositions aligned", "[16] [square] [aligned]")
     REQUIRE(computed == output_16x16);
 }
 
+TEST_CASE("square 16x16 bit transpositions out of place", "[16] [square]") {
+    std::array<std::uint16_t, 16> computed;
+    transpose_bit_16x16(computed.data(), input_16x16.data());
+    REQUIRE(computed == output_16x16);
+}
+
+TEST_CASE("square 16x16 bit transpositions out of place aligned", "[16] [square] [aligned]") {
+    std::array<std::uint16_t, 16> computed alignas(32);
+    transpose_bit_16x16_aligned(computed.data(), input_16x16.data());
+    REQUIRE(computed == output_16x16);
+}
+
 TEST_CASE("square 32x32 bit transpositions", "[32] [square]") {
     std::array<std::uint32_t, 32> computed;
     std::copy(std::begin(input_32x32), std::end(input_32x32), std::begin(computed));
@@ -85,6 +116,18 @@ TEST_CASE("square 32x32 bit transpositions aligned", "[32] [square] [aligned]")
     REQUIRE(computed == output_32x32);
 }
 
+TEST_CASE("square 32x32 bit transpositions out of place", "[32] [square]") {
+    std::array<std::uint32_t, 32> computed;
+    transpose_bit_32x32(computed.data(), input_32x32.data());
+    REQUIRE(computed == output_32x32);
+}
+
+TEST_CASE("square 32x32 bit transpositions out of place aligned", "[32] [square] [aligned]") {
+    std::array<std::uint32_t, 32> computed alignas(32);
+    transpose_bit_32x32_aligned(computed.data(), input_32x32.data());
+    REQUIRE(computed == output_32x32);
+}
+
 TEST_CASE("square 64x64 bit transpositions", "[64] [square]") {
     std::array<std::uint64_t, 64> computed;
     std::copy(std::begin(input_64x64), std::end(input_64x64), std::begin(computed));
@@ -99,6 +142,18 @@ TEST_CASE("square 64x64 bit transpositions aligned", "[64] [square] [aligned]")
     REQUIRE(computed == output_64x64);
 }
 
+TEST_CASE("square 64x64 bit transpositions out of place", "[64] [square]") {
+    std::array<std::uint64_t, 64> computed;
+    transpose_bit_64x64(computed.data(), input_64x64.data());
+    REQUIRE(computed == output_64x64);
+}
+
+TEST_CASE("square 64x64 bit transpositions out of place aligned", "[64] [square] [aligned]") {
+    std::array<std::uint64_t, 64> computed alignas(32);
+    transpose_bit_64x64_aligned(computed.data(), input_64x64.data());
+    REQUIRE(computed == output_64x64);
+}
+
 TEST_CASE("square 128x128 bit transpositions", "[128] [square]") {
     std::array<__m128i, 128> computed;
     std::copy(std::begin(input_128x128), std::end(input_128x128), std::begin(computed));
@@ -114,3 +169,61 @@ TEST_CASE("square 128x128 bit transpositions aligned", "[128] [square] [aligned]
     REQUIRE(std::memcmp(computed.data(), output_128x128.data(), computed.size() * sizeof(__m128i))
             == 0);
 }
+
+TEST_CASE("square 128x128 bit transpositions out of place", "[128] [square]") {
+    std::array<__m128i, 128> computed;
+    transpose_bit_128x128(computed.data(), input_128x128.data());
+    REQUIRE(std::memcmp(computed.data(), output_128x128.data(), computed.size() * sizeof(__m128i))
+            == 0);
+}
+
+TEST_CASE("square 128x128 bit transpositions out of place aligned", "[128] [square] [aligned]") {
+    std::array<__m128i, 128> computed alignas(32);
+    transpose_bit_128x128_aligned(computed.data(), input_128x128.data());
+    REQUIRE(std::memcmp(computed.data(), output_128x128.data(), computed.size() * sizeof(__m128i))
+            == 0);
+}
+
+// Check the batch functions on five copies of the given matrix, so that the
+// odd number of matrices also covers the remainder.
+template <typename T, std::size_t N>
+static void check_batch(const std::array<T, N>& input, const std::array<T, N>& output,
+                        void (*batch)(void*, const void*, std::size_t),
+                        void (*batch_inplace)(void*, std::size_t)) {
+    constexpr std::size_t count = 5;
+    std::array<T, count * N> inputs;
+    std::array<T, count * N> outputs;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::copy(std::begin(input), std::end(input), std::begin(inputs) + i * N);
+        std::copy(std::begin(output), std::end(output), std::begin(outputs) + i * N);
+    }
+    std::array<T, count * N> computed;
+    batch(computed.data(), inputs.data(), count);
+    REQUIRE(std::memcmp(computed.data(), outputs.data(), sizeof(computed)) == 0);
+    batch_inplace(inputs.data(), count);
+    REQUIRE(std::memcmp(inputs.data(), outputs.data(), sizeof(inputs)) == 0);
+}
+
+TEST_CASE("square 8x8 bit transpositions batched", "[8] [square] [batch]") {
+    check_batch(input_8x8, output_8x8, transpose_bit_8x8_batch, transpose_bit_8x8_batch_inplace);
+}
+
+TEST_CASE("square 16x16 bit transpositions batched", "[16] [square] [batch]") {
+    check_batch(input_16x16, output_16x16, transpose_bit_16x16_batch,
+                transpose_bit_16x16_batch_inplace);
+}
+
+TEST_CASE("square 32x32 bit transpositions batched", "[32] [square] [batch]") {
+    check_batch(input_32x32, output_32x32, transpose_bit_32x32_batch,
+                transpose_bit_32x32_batch_inplace);
+}
+
+TEST_CASE("square 64x64 bit transpositions batched", "[64] [square] [batch]") {
+    check_batch(input_64x64, output_64x64, transpose_bit_64x64_batch,
+                transpose_bit_64x64_batch_inplace);
+}
+
+TEST_CASE("square 128x128 bit transpositions batched", "[128] [square] [batch]") {
+    check_batch(input_128x128, output_128x128, transpose_bit_128x128_batch,
+                transpose_bit_128x128_batch_inplace);
+}